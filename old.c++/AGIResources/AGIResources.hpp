@@ -29,6 +29,7 @@ class PlatformAbstractionLayer;
 class GameInfo;
 class GameVolume;
 class GameVolumeEntry;
+class GameVolumeRepacker;
 
 class PictureCallback;
 class PictureDecoder;
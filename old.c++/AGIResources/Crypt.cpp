@@ -0,0 +1,211 @@
+//
+//  Crypt.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "Crypt.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <iterator>
+#include <string.h>
+
+#include "Endian.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CRYPT_X86 1
+#endif
+
+using namespace AGI::Resources;
+
+namespace {
+
+    typedef void (*CryptKernel)(uint8_t* data, size_t length, const uint8_t* block, size_t keyLength);
+
+    /**
+     * XOR whatever is left one byte at a time, starting at the given phase of the key.
+     */
+    inline void cryptTail(uint8_t* data, size_t length, const uint8_t* block, size_t keyLength, size_t phase) {
+        for (size_t i = 0; i < length; i++) {
+            data[i] ^= block[phase];
+
+            if (++phase == keyLength)
+                phase = 0;
+        }
+    }
+
+    void cryptBytes(uint8_t* data, size_t length, const uint8_t* block, size_t keyLength) {
+        cryptTail(data, length, block, keyLength, 0);
+    }
+
+    void cryptWords(uint8_t* data, size_t length, const uint8_t* block, size_t keyLength) {
+        size_t phase = 0;
+        size_t step  = 8 % keyLength;
+        size_t i     = 0;
+
+        for (; i + 8 <= length; i += 8) {
+            uint64_t value, key;
+
+            memcpy(&value, data + i, 8);
+            memcpy(&key, block + phase, 8);
+            value ^= key;
+            memcpy(data + i, &value, 8);
+
+            phase += step;
+            if (phase >= keyLength)
+                phase -= keyLength;
+        }
+
+        cryptTail(data + i, length - i, block, keyLength, phase);
+    }
+
+#if CRYPT_X86
+    __attribute__((target("sse2")))
+    void cryptSSE2(uint8_t* data, size_t length, const uint8_t* block, size_t keyLength) {
+        size_t phase = 0;
+        size_t step  = 16 % keyLength;
+        size_t i     = 0;
+
+        for (; i + 16 <= length; i += 16) {
+            __m128i value = _mm_loadu_si128((const __m128i*)(data + i));
+            __m128i key   = _mm_loadu_si128((const __m128i*)(block + phase));
+
+            _mm_storeu_si128((__m128i*)(data + i), _mm_xor_si128(value, key));
+
+            phase += step;
+            if (phase >= keyLength)
+                phase -= keyLength;
+        }
+
+        cryptTail(data + i, length - i, block, keyLength, phase);
+    }
+
+    __attribute__((target("avx2")))
+    void cryptAVX2(uint8_t* data, size_t length, const uint8_t* block, size_t keyLength) {
+        size_t phase = 0;
+        size_t step  = 32 % keyLength;
+        size_t i     = 0;
+
+        for (; i + 32 <= length; i += 32) {
+            __m256i value = _mm256_loadu_si256((const __m256i*)(data + i));
+            __m256i key   = _mm256_loadu_si256((const __m256i*)(block + phase));
+
+            _mm256_storeu_si256((__m256i*)(data + i), _mm256_xor_si256(value, key));
+
+            phase += step;
+            if (phase >= keyLength)
+                phase -= keyLength;
+        }
+
+        cryptTail(data + i, length - i, block, keyLength, phase);
+    }
+#endif
+
+    struct CryptDispatch {
+        CryptKernel kernel;
+        const char* name;
+    };
+
+    // Fastest first.
+    const CryptDispatch kernels[] = {
+#if CRYPT_X86
+        { cryptAVX2,  "avx2" },
+        { cryptSSE2,  "sse2" },
+#endif
+        { cryptWords, "words" },
+        { cryptBytes, "scalar" },
+    };
+
+    bool supported(const CryptDispatch& candidate) {
+#if CRYPT_X86
+        __builtin_cpu_init();
+
+        if (candidate.kernel == cryptAVX2)
+            return __builtin_cpu_supports("avx2");
+
+        if (candidate.kernel == cryptSSE2)
+            return __builtin_cpu_supports("sse2");
+#else
+        (void)candidate;
+#endif
+        return true;
+    }
+
+    const CryptDispatch& dispatch() {
+        static const CryptDispatch& selected = *std::find_if(std::begin(kernels), std::end(kernels), supported);
+
+        return selected;
+    }
+
+}
+
+CryptKey::CryptKey(const uint8_t* key, size_t length) : _length(length) {
+    assert(length > 0 && length <= MaximumLength);
+
+    for (size_t i = 0; i < sizeof(_block); i++)
+        _block[i] = key[i % length];
+}
+
+void CryptKey::apply(uint8_t* data, size_t length) const {
+    dispatch().kernel(data, length, _block, _length);
+}
+
+bool CryptKey::apply(uint8_t* data, size_t length, const char* kernel) const {
+    for (const CryptDispatch& candidate : kernels) {
+        if (strcmp(candidate.name, kernel) == 0 && supported(candidate)) {
+            candidate.kernel(data, length, _block, _length);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const CryptKey& CryptKey::sierra() {
+    static const CryptKey key(CRYPT_KEY_SIERRA, CRYPT_KEY_LENGTH);
+    return key;
+}
+
+const char* CryptKey::kernel() {
+    return dispatch().name;
+}
+
+void AGI::Resources::decrypt(uint8_t* data, size_t len, const uint8_t* key, size_t keyLength) {
+    if (key == CRYPT_KEY_SIERRA || (keyLength == CRYPT_KEY_LENGTH && memcmp(key, CRYPT_KEY_SIERRA, CRYPT_KEY_LENGTH) == 0)) {
+        CryptKey::sierra().apply(data, len);
+        return;
+    }
+
+    if (keyLength > CryptKey::MaximumLength) {
+        for (size_t i = 0; i < len; i++)
+            *(data + i) ^= *(key + (i % keyLength));
+        return;
+    }
+
+    CryptKey(key, keyLength).apply(data, len);
+}
+
+void AGI::Resources::decryptLogic(uint8_t* data, size_t len, const uint8_t* key, size_t keyLength) {
+    if (len < 2)
+        return;
+
+    uint8_t* m0     = data;
+    uint16_t mstart = readUINT16LE(m0) + 2;
+
+    if ((size_t)mstart + 3 > len)
+        return;
+
+    uint8_t  mc     = m0[mstart];
+    uint16_t mend   = readUINT16LE(m0 + mstart + 1);
+    size_t   left   = len - (mstart + 3);
+
+    m0 += mstart + 3;
+    mstart = mc << 1;
+
+    // Messages of a corrupted logic are only decrypted up to the end of the data.
+    if (mc > 0 && mend > mstart && mstart < left)
+        decrypt(m0 + mstart, std::min<size_t>(mend - mstart, left - mstart), key, keyLength);
+}
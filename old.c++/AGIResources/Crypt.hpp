@@ -0,0 +1,86 @@
+//
+//  Crypt.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__Crypt_hpp__
+#define __AGIResources__Crypt_hpp__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define CRYPT_KEY_SIERRA    (const uint8_t*)("Avis Durgan")
+#define CRYPT_KEY_AGDS      (const uint8_t*)("Alex Simkin")
+#define CRYPT_KEY_LENGTH    11
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Repeating XOR key, expanded once so that it can be applied a whole vector at a
+     * time: the block holds the key repeated past the widest vector, and a vector
+     * starting at any phase of the key is a plain unaligned load out of it.
+     *
+     * The kernel is picked at runtime: AVX2 or SSE2 on x86 when the processor has
+     * them, 8 bytes at a time ("words") otherwise. The byte at a time "scalar"
+     * kernel is only there for comparison.
+     */
+    class CryptKey {
+    public:
+        enum {
+            MaximumLength = 32,
+            VectorSize    = 32,
+        };
+
+    private:
+        uint8_t _block[MaximumLength + VectorSize];
+        size_t  _length;
+
+    public:
+        CryptKey(const uint8_t* key, size_t length);
+
+    public:
+        /**
+         * XOR the data with the key. Being an XOR, it both encrypts and decrypts.
+         */
+        void apply(uint8_t* data, size_t length) const;
+
+        /**
+         * Same as apply(), with the named kernel. Returns false when the kernel is
+         * unknown or this processor cannot run it.
+         */
+        bool apply(uint8_t* data, size_t length, const char* kernel) const;
+
+        inline size_t length() const { return _length; }
+
+    public:
+        static const CryptKey& sierra();
+
+        /**
+         * Name of the kernel used on this processor.
+         */
+        static const char* kernel();
+    };
+
+    /**
+     * XOR the data with the repeated key. Being an XOR, the same call encrypts.
+     */
+    void decrypt(uint8_t* data, size_t len, const uint8_t* key, size_t keyLength);
+
+    /**
+     * Decrypts, or encrypts, the message section of a logic resource.
+     */
+    void decryptLogic(uint8_t* data, size_t len, const uint8_t* key, size_t keyLength);
+
+    inline void encrypt(uint8_t* data, size_t len, const uint8_t* key, size_t keyLength) {
+        decrypt(data, len, key, keyLength);
+    }
+
+    inline void encryptLogic(uint8_t* data, size_t len, const uint8_t* key, size_t keyLength) {
+        decryptLogic(data, len, key, keyLength);
+    }
+
+}}
+
+#endif /* __AGIResources__Crypt_hpp__ */
@@ -8,14 +8,26 @@
 #ifndef __AGIResources__Endian_hpp__
 #define __AGIResources__Endian_hpp__
 
+#include <stdint.h>
+#include <string.h>
+
 namespace AGI { namespace Resources {
 
-    inline uint16_t readUINT16LE(uint8_t* data) {
+    inline uint16_t readUINT16LE(const uint8_t* data) {
        uint16_t low  = data[0];
        uint16_t high = data[1];
        return (high << 8) | low;
     }
 
+    inline uint64_t readUINT64LE(const uint8_t* data) {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = __builtin_bswap64(value);
+#endif
+        return value;
+    }
+
 }}
 
 #endif /* __AGIResources__Endian_hpp__ */
@@ -0,0 +1,79 @@
+//
+//  GameDatabase.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "GameDatabase.hpp"
+
+#include <algorithm>
+
+using namespace AGI::Resources;
+
+static constexpr int hexDigit(char c) {
+    return (c >= '0' && c <= '9') ? c - '0' :
+           (c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+           (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+}
+
+static constexpr uint64_t digestHalf(const char* md5, size_t offset) {
+    uint64_t value = 0;
+
+    for (size_t index = 0; index < 16; index++)
+        value = (value << 4) | (uint64_t)hexDigit(md5[offset + index]);
+
+    return value;
+}
+
+#define GAME(code, description, md5, version, flags) \
+    { digestHalf(md5, 0), digestHalf(md5, 16), code, description, version, flags }
+
+// Keep sorted by digest, this is checked at compile time.
+static constexpr GameDatabaseEntry gameDatabase[] = {
+    GAME("kq1", "2.0F 1987-05-05 5.25\"/3.5\"", "10ad66e2ecbd66951534a50aedcd0128", 0x2917, 0),
+    GAME("kq2", "2.1 1987-04-10",               "759e39f891a0e1d86dd29d7de485c6ac", 0x2440, 0),
+    GAME("kq3", "2.14 1988-03-15 3.5\"",        "d3d17b77b3b3cd13246749231d9473cd", 0x2936, 0),
+    GAME("kq4", "2.0 1988-07-27 3.5\"",         "fe44655c42f16c6f81046fdf169b6337", 0x3086, 0),
+};
+
+#undef GAME
+
+static const size_t gameDatabaseCount = sizeof(gameDatabase) / sizeof(gameDatabase[0]);
+
+static constexpr bool isBefore(const GameDatabaseEntry& a, const GameDatabaseEntry& b) {
+    return a.digestHigh < b.digestHigh || (a.digestHigh == b.digestHigh && a.digestLow < b.digestLow);
+}
+
+static constexpr bool isSorted() {
+    for (size_t index = 1; index < gameDatabaseCount; index++) {
+        if (!isBefore(gameDatabase[index - 1], gameDatabase[index]))
+            return false;
+    }
+
+    return true;
+}
+
+static_assert(isSorted(), "The game database must be sorted by digest, without duplicates");
+
+const GameDatabaseEntry* GameDatabase::find(const std::string& md5) {
+    if (md5.size() != 32)
+        return nullptr;
+
+    for (char c : md5) {
+        if (hexDigit(c) < 0)
+            return nullptr;
+    }
+
+    GameDatabaseEntry key = { digestHalf(md5.c_str(), 0), digestHalf(md5.c_str(), 16), nullptr, nullptr, 0, 0 };
+    auto              it  = std::lower_bound(gameDatabase, gameDatabase + gameDatabaseCount, key, isBefore);
+
+    if (it == gameDatabase + gameDatabaseCount || isBefore(key, *it))
+        return nullptr;
+
+    return it;
+}
+
+Span<const GameDatabaseEntry> GameDatabase::entries() {
+    return Span<const GameDatabaseEntry>(gameDatabase, gameDatabaseCount);
+}
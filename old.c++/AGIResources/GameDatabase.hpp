@@ -0,0 +1,50 @@
+//
+//  GameDatabase.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__GameDatabase_hpp__
+#define __AGIResources__GameDatabase_hpp__
+
+#include "AGIResources.hpp"
+#include "Span.hpp"
+
+namespace AGI { namespace Resources {
+
+    /**
+     * A known release, identified by the MD5 digest of its directory file: logdir
+     * for v2 games, the combined directory for v3 games. The digest is stored as
+     * two big endian halves so that entries compare as plain integers.
+     */
+    class GameDatabaseEntry
+    {
+    public:
+        uint64_t    digestHigh;
+        uint64_t    digestLow;
+        const char* code;
+        const char* description;
+        uint32_t    version;
+        uint32_t    flags;
+    };
+
+    /**
+     * Table of known releases, built at compile time and sorted by digest, so that
+     * a lookup is a binary search no matter how many releases are listed.
+     */
+    class GameDatabase
+    {
+    public:
+        /**
+         * Returns the release whose directory has the given digest, written as 32
+         * hexadecimal digits, or nullptr when it is unknown.
+         */
+        static const GameDatabaseEntry* find(const std::string& md5);
+
+        static Span<const GameDatabaseEntry> entries();
+    };
+
+}}
+
+#endif /* __AGIResources__GameDatabase_hpp__ */
@@ -7,23 +7,92 @@
 
 #include "GameInfo.hpp"
 
+#include "GameDatabase.hpp"
 #include "PlatformAbstractionLayer.hpp"
 
 #include <algorithm>
 #include <memory>
-#include <regex>
+#include <stdexcept>
+#include <strings.h>
 
 using namespace AGI::Resources;
 
-GameInfo::GameInfo(const std::string& code, const std::string& description, uint32_t version, uint32_t flags, const std::unordered_map<GameFile, std::string>& files) : _code(code), _description(description), _version(version), _flags(flags), _files(files) {
+GameInfo::GameInfo(const std::string& code, const std::string& description, uint32_t version, uint32_t flags, const std::unordered_map<GameFile, std::string>& files) : _code(code), _description(description), _version(version), _flags(flags), _filesPresent(0) {
+    for (const auto& file : files) {
+        if (file.first > GameFile::Words)
+            continue;
+
+        _files[(size_t)file.first] = file.second;
+        _filesPresent |= 1u << (size_t)file.first;
+    }
+}
+
+const std::string& GameInfo::file(GameFile file) const {
+    if (!hasFile(file))
+        throw std::runtime_error(format("Game file %i does not exists", (int)file));
+
+    return _files[(size_t)file];
+}
+
+std::unordered_map<GameFile, std::string> GameInfo::files() const {
+    std::unordered_map<GameFile, std::string> files;
+
+    for (size_t index = 0; index <= (size_t)GameFile::Words; index++) {
+        if (hasFile((GameFile)index))
+            files.emplace((GameFile)index, _files[index]);
+    }
+
+    return files;
+}
+
+static inline bool isWordCharacter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * Matches "<prefix>vol.<digit>", case insensitively, where the prefix is made of
+ * exactly prefixLength word characters, or of at least one of them when
+ * prefixLength is -1. The separator can be any character. Returns the volume
+ * number, or -1 when the name does not match.
+ */
+static int volumeNumber(const std::string& file, int prefixLength) {
+    size_t length = file.size();
+
+    if (length < 5 || !isDigit(file[length - 1]) || strncasecmp(file.c_str() + length - 5, "vol", 3) != 0)
+        return -1;
+
+    size_t prefix = length - 5;
+
+    if (prefixLength >= 0 ? prefix != (size_t)prefixLength : prefix == 0)
+        return -1;
+
+    if (!std::all_of(file.begin(), file.begin() + prefix, isWordCharacter))
+        return -1;
+
+    return file[length - 1] - '0';
+}
+
+/**
+ * Matches "<prefix>dir", case insensitively, with a prefix of at least one word
+ * character.
+ */
+static bool isDirectoryV3(const std::string& file) {
+    size_t length = file.size();
+
+    if (length < 4 || strcasecmp(file.c_str() + length - 3, "dir") != 0)
+        return false;
+
+    return std::all_of(file.begin(), file.end() - 3, isWordCharacter);
 }
 
 static std::unordered_map<GameFile, std::string> buildV2(const std::vector<std::string>& files)
 {
     std::unordered_map<GameFile, std::string> map;
 
-    std::regex volumeMatch("^vol.(\\d)$", std::regex::icase);
-
     for (const auto& file : files) {
         if (strcasecmp(file.c_str(), "logdir") == 0) {
             map.emplace(std::make_pair(GameFile::Logic, file));
@@ -50,12 +119,10 @@ static std::unordered_map<GameFile, std::string> buildV2(const std::vector<std::
             continue;
         }
 
-        std::smatch m;
+        int volumeID = volumeNumber(file, 0);
 
-        if (regex_search(file, m, volumeMatch)) {
-            uint8_t volumeID = (uint8_t)std::stoi(m[1]);
+        if (volumeID >= 0)
             map.emplace(std::make_pair((GameFile)((uint8_t)GameFile::Volume_0 + volumeID), file));
-        }
     }
 
     return map;
@@ -65,9 +132,6 @@ static std::unordered_map<GameFile, std::string> buildV3(const std::vector<std::
 {
     std::unordered_map<GameFile, std::string> map;
 
-    std::regex volumeMatch("^(\\w+)vol.(\\d)$", std::regex::icase);
-    std::regex dirMatch("^(\\w+)dir$", std::regex::icase);
-
     for (const auto& file : files) {
         if (strcasecmp(file.c_str(), "words.tok") == 0) {
             map.emplace(std::make_pair(GameFile::Words, file));
@@ -77,17 +141,15 @@ static std::unordered_map<GameFile, std::string> buildV3(const std::vector<std::
             map.emplace(std::make_pair(GameFile::Objects, file));
             continue;
         }
-        else if (regex_match(file, dirMatch)) {
+        else if (isDirectoryV3(file)) {
             map.emplace(std::make_pair(GameFile::Directory, file));
             continue;
         }
 
-        std::smatch m;
+        int volumeID = volumeNumber(file, -1);
 
-        if (regex_search(file, m, volumeMatch)) {
-            uint8_t volumeID = (uint8_t)std::stoi(m[2]);
+        if (volumeID >= 0)
             map.emplace(std::make_pair((GameFile)((uint8_t)GameFile::Volume_0 + volumeID), file));
-        }
     }
 
     return map;
@@ -98,15 +160,11 @@ static GameInfo detectV2(PlatformAbstractionLayer& platform) {
     if (map.count(GameFile::Logic) == 0)
         throw std::runtime_error("Not an AGI v2 game");
 
-    std::string logdirHash(platform.fileMD5Hash(map[GameFile::Logic].c_str()));
-
-#define GAME_LD(code, desc, md5, version, flags) \
-    if (logdirHash == md5) \
-        return GameInfo(code, desc, version, flags, map)
+    std::string              logdirHash(platform.fileMD5Hash(map[GameFile::Logic].c_str()));
+    const GameDatabaseEntry* known = GameDatabase::find(logdirHash);
 
-    GAME_LD("kq1", "2.0F 1987-05-05 5.25\"/3.5\"", "10ad66e2ecbd66951534a50aedcd0128", 0x2917, 0);
-    GAME_LD("kq2", "2.1 1987-04-10", "759e39f891a0e1d86dd29d7de485c6ac", 0x2440, 0);
-    GAME_LD("kq3", "2.14 1988-03-15 3.5\"", "d3d17b77b3b3cd13246749231d9473cd", 0x2936, 0);
+    if (known && known->version < 0x3000)
+        return GameInfo(known->code, known->description, known->version, known->flags, map);
 
     return GameInfo("agiv2", std::string("Unknown AGI v2 game ") + logdirHash, 0x2917, 0, map);
 }
@@ -116,9 +174,11 @@ static GameInfo detectV3(PlatformAbstractionLayer& platform) {
     if (map.count(GameFile::Directory) == 0)
         throw std::runtime_error("Not an AGI v3 game");
 
-    std::string logdirHash(platform.fileMD5Hash(map[GameFile::Directory].c_str()));
+    std::string              logdirHash(platform.fileMD5Hash(map[GameFile::Directory].c_str()));
+    const GameDatabaseEntry* known = GameDatabase::find(logdirHash);
 
-    GAME_LD("kq4", "2.0 1988-07-27 3.5\"", "fe44655c42f16c6f81046fdf169b6337", 0x3086, 0);
+    if (known && known->version >= 0x3000)
+        return GameInfo(known->code, known->description, known->version, known->flags, map);
 
     return GameInfo("agiv3", std::string("Unknown AGI v3 game ") + logdirHash, 0x3086, 0, map);
 }
@@ -25,7 +25,8 @@ namespace AGI { namespace Resources {
         uint32_t    _version;
         uint32_t    _flags;
 
-        std::unordered_map<GameFile, std::string> _files;
+        std::string _files[(size_t)GameFile::Words + 1];
+        uint32_t    _filesPresent;
 
     public:
         GameInfo(const std::string& code, const std::string& description, uint32_t version, uint32_t flags, const std::unordered_map<GameFile, std::string>& files);
@@ -35,7 +36,10 @@ namespace AGI { namespace Resources {
         inline const std::string& description() const { return _description; }
         inline uint32_t version() const { return _version; }
         inline uint32_t flags() const { return _flags; }
-        inline const std::unordered_map<GameFile, std::string>& files() const { return _files; }
+        inline bool hasFile(GameFile file) const { return (_filesPresent >> (size_t)file) & 1; }
+
+        const std::string& file(GameFile file) const;
+        std::unordered_map<GameFile, std::string> files() const;
 
     public:
         static GameInfo detect(PlatformAbstractionLayer& platform);
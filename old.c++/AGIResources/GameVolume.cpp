@@ -7,86 +7,144 @@
 
 #include "GameVolume.hpp"
 
+#include "Crypt.hpp"
 #include "Endian.hpp"
+#include "GameVolumeIndex.hpp"
 #include "LZWExpand.hpp"
+#include "PictureExpand.hpp"
 #include "PlatformAbstractionLayer.hpp"
 
+#include <algorithm>
+#include <assert.h>
+#include <stdexcept>
+#include <string.h>
+
 using namespace AGI::Resources;
 
 GameVolume::GameVolume(PlatformAbstractionLayer* platform) : _info(GameInfo::detect(*platform)), _platform(platform) {
-    parseDirectory();
 }
 
 GameVolume::GameVolume(const GameInfo& info, PlatformAbstractionLayer* platform) : _info(info), _platform(platform) {
-    parseDirectory();
 }
 
-void GameVolume::parseDirectory() {
-    if (_info.version() >= 0x3000)
-        parseDirectoryV3();
+GameVolume::GameVolume(PlatformAbstractionLayer* platform, const char* indexFileName) : GameVolume(platform, GameVolumeIndex::read(*platform, indexFileName), indexFileName) {
+}
+
+GameVolume::GameVolume(PlatformAbstractionLayer* platform, std::unique_ptr<GameVolumeIndex>&& index, const char* indexFileName) : _platform(platform), _info(index ? index->info() : GameInfo::detect(*platform)) {
+    if (index) {
+        restoreDirectory(*index);
+        return;
+    }
+
+    writeIndex(indexFileName);
+}
+
+bool GameVolume::writeIndex(const char* indexFileName) const {
+    if (GameVolumeIndex::write(*_platform, indexFileName, *this))
+        return true;
+
+    _platform->log("Failed to write resource index %s", indexFileName);
+    return false;
+}
+
+void GameVolume::restoreDirectory(const GameVolumeIndex& index) {
+    for (size_t file = 0; file <= (size_t)GameFile::Words; file++) {
+        if ((GameFile)file > GameFile::Volume_9 && (GameFile)file != GameFile::Objects && (GameFile)file != GameFile::Words)
+            continue;
+
+        if (!_info.hasFile((GameFile)file))
+            continue;
+
+        const char* fileName = _info.file((GameFile)file).c_str();
+        size_t      size     = _platform->fileSize(fileName);
+        if (size != (size_t)-1)
+            _views[file] = _platform->fileView(fileName, 0, size);
+    }
+
+    // The index holds every directory, none of them is parsed afterward.
+    for (size_t type = 0; type < DirectoryCount; type++) {
+        std::call_once(_directoryOnce[type], [this, &index, type]() {
+            GameFile file = (GameFile)((size_t)GameFile::Logic + type);
+
+            for (const auto& entry : index.entries()) {
+                if (entry.type == file)
+                    _directories[type].set(entry.id, entry.entry);
+            }
+        });
+    }
+}
+
+const GameVolumeDirectory* GameVolume::directory(GameFile file) const {
+    if (file < GameFile::Logic || file > GameFile::Words)
+        return nullptr;
+
+    size_t type = (size_t)file - (size_t)GameFile::Logic;
+
+    std::call_once(_directoryOnce[type], [this, file]() {
+        const_cast<GameVolume*>(this)->parseDirectory(file);
+    });
+
+    return &_directories[type];
+}
+
+void GameVolume::parseDirectory(GameFile file) {
+    if (file == GameFile::Objects || file == GameFile::Words)
+        parsePlainFileEntry(file);
+    else if (_info.version() >= 0x3000)
+        parseDirectoryV3(file);
     else
-        parseDirectoryV2();
+        loadDirectoryV2(file, volumes());
 }
 
 static inline GameFile volumeToGameFile(uint8_t volume) {
     return (GameFile)((uint8_t)GameFile::Volume_0 + volume);
 }
 
+const GameVolume::volume_sizes_t& GameVolume::volumes() {
+    std::call_once(_volumesOnce, [this]() { _volumeSizes = gatherVolumeSizes(); });
+
+    return _volumeSizes;
+}
+
 GameVolume::volume_sizes_t GameVolume::gatherVolumeSizes() {
     uint8_t volume = 0;
     GameVolume::volume_sizes_t results;
 
-    auto& files = _info.files();
-
-    for (;; volume++) {
-        auto it(files.find(volumeToGameFile(volume)));
-        if (it == files.end())
+    for (; volume <= 9; volume++) {
+        if (!_info.hasFile(volumeToGameFile(volume)))
             break;
 
-        size_t size = _platform->fileSize(it->second.c_str());
+        const char* fileName = _info.file(volumeToGameFile(volume)).c_str();
+        size_t      size     = _platform->fileSize(fileName);
         if (size == (size_t)-1)
             break;
 
         results.emplace(volumeToGameFile(volume), size);
+        _views[(size_t)volumeToGameFile(volume)] = _platform->fileView(fileName, 0, size);
     }
 
     return results;
 }
 
-void GameVolume::parseObjectsAndWordsEntries() {
-    size_t objectFileSize = _platform->fileSize(_info.files().at(GameFile::Objects).c_str());
-    size_t wordsFileSize = _platform->fileSize(_info.files().at(GameFile::Words).c_str());
-    if (objectFileSize == (size_t)-1 || wordsFileSize == (size_t)-1)
+void GameVolume::parsePlainFileEntry(GameFile file) {
+    size_t fileSize = _platform->fileSize(_info.file(file).c_str());
+    if (fileSize == (size_t)-1)
         throw std::runtime_error("Failed to determine size of words/objects resources");
+    if (fileSize > GameVolumeEntry::MaximumLength)
+        throw std::runtime_error(format("Game file %i is too large", (int)file));
 
-    _entries.emplace(GameFile::Objects, std::unordered_map<int, GameVolumeEntry>({ std::make_pair(0, GameVolumeEntry(GameFile::Objects, 0, objectFileSize)) }));
-    _entries.emplace(GameFile::Words, std::unordered_map<int, GameVolumeEntry>({ std::make_pair(0, GameVolumeEntry(GameFile::Words, 0, wordsFileSize)) }));
-}
-
-void GameVolume::parseDirectoryV2() {
-    parseObjectsAndWordsEntries();
-
-    auto volumeSizes(gatherVolumeSizes());
-
-    loadDirectoryV2(GameFile::Picture, volumeSizes);
-    loadDirectoryV2(GameFile::View, volumeSizes);
-    loadDirectoryV2(GameFile::Sound, volumeSizes);
-    loadDirectoryV2(GameFile::Logic, volumeSizes);
+    _views[(size_t)file] = _platform->fileView(_info.file(file).c_str(), 0, fileSize);
+    _directories[(size_t)file - (size_t)GameFile::Logic].set(0, GameVolumeEntry(file, 0, fileSize));
 }
 
-void GameVolume::parseDirectoryV3() {
-    parseObjectsAndWordsEntries();
-
-    std::string dirFile = _info.files().at(GameFile::Directory);
-    size_t fileSize = _platform->fileSize(dirFile.c_str());
-    if (fileSize == (size_t)-1)
-        throw std::runtime_error("Failed to determine size of resource directory");
-
-    std::vector<uint8_t> dirData;
-
-    dirData.resize(fileSize);
-    if (!_platform->fileRead(dirFile.c_str(), 0, dirData.data(), fileSize))
-        throw std::runtime_error("Failed to read resource directory");
+/**
+ * The v3 directory file starts with the offsets of the logic, picture, view and
+ * sound directories, in that order, each one running up to the next.
+ */
+void GameVolume::parseDirectoryV3(GameFile file) {
+    std::vector<uint8_t> dirBuffer;
+    Span<const uint8_t>  dirData(readDirectory(_info.file(GameFile::Directory), dirBuffer));
+    size_t               fileSize = dirData.size();
 
     const uint16_t* dirOffsets = (const uint16_t*)dirData.data();
     uint16_t dirLengths[4] = {0, 0, 0, 0};
@@ -98,12 +156,16 @@ void GameVolume::parseDirectoryV3() {
             dirLengths[i] = dirOffsets[i + 1] - dirOffsets[i];
     }
 
-    auto volumeSizes(gatherVolumeSizes());
+    int section;
+
+    switch (file) {
+    case GameFile::Logic:   section = 0; break;
+    case GameFile::Picture: section = 1; break;
+    case GameFile::View:    section = 2; break;
+    default:                section = 3; break;
+    }
 
-    loadDirectoryV3(GameFile::Logic,   (dirData.data() + dirOffsets[0]), dirLengths[0], volumeSizes);
-    loadDirectoryV3(GameFile::Picture, (dirData.data() + dirOffsets[1]), dirLengths[1], volumeSizes);
-    loadDirectoryV3(GameFile::View,    (dirData.data() + dirOffsets[2]), dirLengths[2], volumeSizes);
-    loadDirectoryV3(GameFile::Sound,   (dirData.data() + dirOffsets[3]), dirLengths[3], volumeSizes);
+    loadDirectoryV3(file, (dirData.data() + dirOffsets[section]), dirLengths[section], volumes());
 }
 
 class GameVolumeEntryBuilder {
@@ -126,29 +188,36 @@ public:
     }
 };
 
-void GameVolume::loadDirectoryV2(GameFile file, const volume_sizes_t& volumeSizes) {
-    std::string dirFile = _info.files().at(file);
+Span<const uint8_t> GameVolume::readDirectory(const std::string& dirFile, std::vector<uint8_t>& storage) {
     size_t fileSize = _platform->fileSize(dirFile.c_str());
     if (fileSize == (size_t)-1)
-        throw std::runtime_error(format("Failed to determine size of resource %i directory", (int)file));
+        throw std::runtime_error(format("Failed to determine size of resource directory %s", dirFile.c_str()));
 
-    std::vector<uint8_t> dirData;
+    Span<const uint8_t> mapped(_platform->fileView(dirFile.c_str(), 0, fileSize));
+    if (!mapped.empty())
+        return mapped;
 
-    dirData.resize(fileSize);
-    if (!_platform->fileRead(dirFile.c_str(), 0, dirData.data(), fileSize))
-        throw std::runtime_error(format("Failed to read resource %i directory", (int)file));
+    storage.resize(fileSize);
+    if (!_platform->fileRead(dirFile.c_str(), 0, storage.data(), fileSize))
+        throw std::runtime_error(format("Failed to read resource directory %s", dirFile.c_str()));
 
-    loadDirectoryV3(file, dirData.data(), fileSize, volumeSizes);
+    return Span<const uint8_t>(storage.data(), storage.size());
 }
 
-void GameVolume::loadDirectoryV3(GameFile file, uint8_t* offsets, size_t length, const volume_sizes_t& volumeSizes) {
+void GameVolume::loadDirectoryV2(GameFile file, const volume_sizes_t& volumeSizes) {
+    std::vector<uint8_t> dirBuffer;
+    Span<const uint8_t>  dirData(readDirectory(_info.file(file), dirBuffer));
+
+    loadDirectoryV3(file, dirData.data(), dirData.size(), volumeSizes);
+}
+
+void GameVolume::loadDirectoryV3(GameFile file, const uint8_t* offsets, size_t length, const volume_sizes_t& volumeSizes) {
     assert(length % 3 == 0);
 
-    std::unordered_map<int, GameVolumeEntry> map;
+    GameVolumeDirectory* dir = &_directories[(size_t)file - (size_t)GameFile::Logic];
     std::vector<GameVolumeEntryBuilder> entries;
 
     entries.reserve(length / 3);
-    map.reserve(length / 3);
 
     for (uint8_t i = 0; length; i++, offsets += 3, length -= 3) {
         uint8_t volume = offsets[0] >> 4;
@@ -175,6 +244,10 @@ void GameVolume::loadDirectoryV3(GameFile file, uint8_t* offsets, size_t length,
         size_t offset = (*it).offset;
         size_t nextOffset = (*it).offset;
 
+        // Several entries may share the same data.
+        while (next != entries.end() && (*next).volume == (*it).volume && (*next).offset == offset)
+            ++next;
+
         if (next == entries.end())
             nextOffset = volumeSizes.at(volume);
         else if ((*next).volume != (*it).volume)
@@ -182,174 +255,580 @@ void GameVolume::loadDirectoryV3(GameFile file, uint8_t* offsets, size_t length,
         else
             nextOffset = (*next).offset;
 
-        map.emplace((*it).index, GameVolumeEntry(volume, offset, nextOffset - offset));
-    }
+        if (nextOffset < offset || (nextOffset - offset) > GameVolumeEntry::MaximumLength)
+            throw std::runtime_error(format("Directory %i entry %i lies outside of volume %i", (int)file, (int)(*it).index, (int)(*it).volume));
 
-    _entries.emplace(file, map);
+        dir->set((*it).index, GameVolumeEntry(volume, offset, nextOffset - offset));
+    }
 }
 
 bool GameVolume::exists(GameFile file, uint8_t id) const {
-    if (_entries.count(file) == 0)
-        return false;
-
-    const auto& map = _entries.at(file);
-    if (map.count(id) == 0)
-        return false;
+    const GameVolumeDirectory* dir = directory(file);
 
-    return true;
+    return dir && dir->exists(id);
 }
 
 std::vector<uint8_t> GameVolume::load(GameFile file, uint8_t id) {
-    if (_info.version() >= 0x3000)
-        return loadV3(file, id);
-    else
-        return loadV2(file, id);
+    if (_cache.bypassed())
+        return decode(file, id);
+
+    if (_cache.budget() == 0) {
+        GameResource cached(_cache.find(file, id));
+        if (cached)
+            return *cached;
+
+        return decode(file, id);
+    }
+
+    return *loadShared(file, id);
 }
 
-#define CRYPT_KEY_SIERRA    (uint8_t*)("Avis Durgan")
-#define CRYPT_KEY_AGDS      (uint8_t*)("Alex Simkin")
-#define CRYPT_KEY_LENGTH    11
+// Gap between two requested ranges of the same volume below which loadBatch()
+// reads the bytes in between rather than issuing a second read.
+static const size_t BatchMergeGap = 4096;
 
-static void decrypt(uint8_t* data, size_t len, uint8_t* key, size_t keyLength) {
-    for (size_t i = 0; i < len; i++)
-        *(data + i) ^= *(key + (i % keyLength));
+class GameVolumeBatchItem {
+public:
+    size_t             index;
+    GameVolumeLocation location;
+
+public:
+    GameVolumeBatchItem(size_t i, const GameVolumeLocation& l) : index(i), location(l) {
+    }
+
+    bool operator < (const GameVolumeBatchItem& other) const {
+        if (location.entry.file() != other.location.entry.file())
+            return location.entry.file() < other.location.entry.file();
+
+        return location.entry.offset() < other.location.entry.offset();
+    }
+};
+
+std::vector<std::vector<uint8_t>> GameVolume::loadBatch(Span<const std::pair<GameFile, uint8_t>> requests) {
+    std::vector<std::vector<uint8_t>> results(requests.size());
+    std::vector<GameVolumeBatchItem>  items;
+
+    items.reserve(requests.size());
+
+    for (size_t index = 0; index < requests.size(); index++) {
+        GameFile file = requests[index].first;
+        uint8_t  id   = requests[index].second;
+
+        if (!_cache.bypassed()) {
+            GameResource cached(_cache.find(file, id));
+            if (cached) {
+                results[index] = *cached;
+                continue;
+            }
+        }
+
+        items.push_back(GameVolumeBatchItem(index, GameVolumeLocation(file, id, entry(file, id))));
+    }
+
+    std::sort(items.begin(), items.end());
+
+    std::vector<uint8_t> window;
+
+    for (auto it = items.begin(); it != items.end(); ) {
+        GameFile volumeFile = it->location.entry.file();
+        size_t   start      = it->location.entry.offset();
+        size_t   stop       = start + it->location.entry.length();
+        auto     next       = it + 1;
+
+        for (; next != items.end() && next->location.entry.file() == volumeFile; ++next) {
+            if (next->location.entry.offset() > stop + BatchMergeGap)
+                break;
+
+            stop = std::max(stop, next->location.entry.offset() + next->location.entry.length());
+        }
+
+        const Span<const uint8_t>& mapped = _views[(size_t)volumeFile];
+        Span<const uint8_t>        data;
+
+        if (!mapped.empty() && stop <= mapped.size()) {
+            data = mapped.subspan(start, stop - start);
+        }
+        else {
+            window.resize(stop - start);
+
+            if (!_platform->fileRead(_info.file(volumeFile).c_str(), start, window.data(), window.size()))
+                throw std::runtime_error(format("Failed to read volume %i", (int)volumeFile));
+
+            data = Span<const uint8_t>(window.data(), window.size());
+        }
+
+        for (; it != next; ++it) {
+            const GameVolumeLocation& location = it->location;
+            Span<const uint8_t>       raw(data.subspan(location.entry.offset() - start, location.entry.length()));
+
+            results[it->index] = decodeRaw(location.type, raw);
+
+            if (_cache.budget() > 0)
+                _cache.insert(location.type, location.id, std::make_shared<const std::vector<uint8_t>>(results[it->index]), false);
+        }
+    }
+
+    return results;
+}
+
+GameResource GameVolume::loadShared(GameFile file, uint8_t id) {
+    GameResource cached(_cache.find(file, id));
+    if (cached)
+        return cached;
+
+    return _cache.insert(file, id, std::make_shared<const std::vector<uint8_t>>(decode(file, id)), false);
+}
+
+GameResource GameVolume::pin(GameFile file, uint8_t id) {
+    GameResource cached(_cache.findAndPin(file, id));
+    if (cached)
+        return cached;
+
+    return _cache.insert(file, id, std::make_shared<const std::vector<uint8_t>>(decode(file, id)), true);
+}
+
+void GameVolume::unpin(GameFile file, uint8_t id) {
+    _cache.setPinned(file, id, false);
+}
+
+void GameVolume::setCacheBudget(size_t bytes) {
+    _cache.setBudget(bytes);
+}
+
+GameVolumeLoader& GameVolume::loader() {
+    std::call_once(_loaderOnce, [this]() { _loader.reset(new GameVolumeLoader(*this)); });
+
+    return *_loader;
+}
+
+GameLoadRequest GameVolume::loadAsync(GameFile file, uint8_t id, GameLoadPriority priority) {
+    return loader().enqueue(file, id, priority);
+}
+
+void GameVolume::prefetch(GameFile file, uint8_t id) {
+    if (_cache.budget() == 0)
+        return;
+
+    GameResource cached(_cache.find(file, id));
+    if (cached)
+        return;
+
+    loadAsync(file, id, GameLoadPriority::Prefetch);
+}
+
+void GameVolume::cancelPendingLoads() {
+    loader().cancelAll();
 }
 
-static void decryptLogic(uint8_t* data, size_t len, uint8_t* key, size_t keyLength) {
-    uint8_t* m0     = data;
-    uint16_t mstart = readUINT16LE(m0) + 2;
-    uint8_t  mc     = m0[mstart];
-    uint16_t mend   = readUINT16LE(m0 + mstart + 1);
+/**
+ * Decodes a resource into the memory returned by allocate(length), which is
+ * called once with the decoded length before anything is decoded.
+ */
+template<typename Allocate>
+void GameVolume::decodeWith(GameFile file, uint8_t id, const Allocate& allocate) {
+    GameVolumeEntry e(entry(file, id));
+
+    if (file == GameFile::Words || file == GameFile::Objects) {
+        loadPlain(file, e, allocate(e.length()));
+        return;
+    }
 
-    m0 += mstart + 3;
-    mstart = mc << 1;
+    uint8_t             header[7];
+    Span<const uint8_t> payload(readHeader(e, header));
 
-    if (mc > 0)
-        decrypt(m0 + mstart, mend - mstart, key, keyLength);
+    decodeResource(file, id, e, header, payload, allocate(readUINT16LE(header + 3)));
 }
 
-std::vector<uint8_t> GameVolume::loadRaw(GameFile file, uint8_t id) {
-    auto e = entry(file, id);
+std::vector<uint8_t> GameVolume::decode(GameFile file, uint8_t id) {
+    Span<const uint8_t> mapped(view(file, id));
+    if (!mapped.empty())
+        return std::vector<uint8_t>(mapped.begin(), mapped.end());
+
     std::vector<uint8_t> buffer;
 
-    buffer.resize(e.length());
+    decodeWith(file, id, [&buffer](size_t length) {
+        buffer.resize(length);
+        return Span<uint8_t>(buffer.data(), buffer.size());
+    });
 
-    if (!_platform->fileRead(_info.files().at(e.file()).c_str(), e.offset(), buffer.data(), e.length()))
+    return buffer;
+}
+
+MemoryBuffer GameVolume::load(GameFile file, uint8_t id, MemoryResource& memory) {
+    MemoryBuffer buffer((MemoryAllocator<uint8_t>(&memory)));
+
+    decodeWith(file, id, [&buffer](size_t length) {
+        buffer.resize(length);
+        return Span<uint8_t>(buffer.data(), buffer.size());
+    });
+
+    return buffer;
+}
+
+size_t GameVolume::decodedSize(GameFile file, uint8_t id) {
+    GameVolumeEntry e(entry(file, id));
+
+    if (file == GameFile::Words || file == GameFile::Objects)
+        return e.length();
+
+    size_t              headerSize = this->headerSize();
+    Span<const uint8_t> raw(entryView(e));
+    uint8_t             header[7];
+
+    if (!raw.empty()) {
+        if (raw.size() < headerSize)
+            throw std::runtime_error("Invalid resource signature");
+
+        memcpy(header, raw.data(), headerSize);
+    }
+    else if (e.length() < headerSize || !_platform->fileRead(_info.file(e.file()).c_str(), e.offset(), header, headerSize))
         throw std::runtime_error(format("Failed to read volume %i", (int)e.file()));
 
-    if (file == GameFile::Objects) {
-        uint16_t n = readUINT16LE(buffer.data());
-        if (n > e.length())
-            decrypt(buffer.data(), buffer.size(), CRYPT_KEY_SIERRA, CRYPT_KEY_LENGTH);
+    if (header[0] != 0x12 || header[1] != 0x34)
+        throw std::runtime_error("Invalid resource signature");
+
+    return readUINT16LE(header + 3);
+}
+
+size_t GameVolume::loadInto(GameFile file, uint8_t id, Span<uint8_t> output) {
+    if (!_cache.bypassed()) {
+        GameResource cached(_cache.find(file, id));
+
+        if (cached) {
+            if (output.size() < cached->size())
+                throw std::runtime_error(format("Buffer too small for directory %i entry %i", (int)file, (int)id));
+
+            if (!cached->empty())
+                memcpy(output.data(), cached->data(), cached->size());
+
+            return cached->size();
+        }
     }
 
-    if (file == GameFile::Words || file == GameFile::Objects)
+    size_t length = 0;
+
+    decodeWith(file, id, [file, id, output, &length](size_t decodedLength) {
+        if (output.size() < decodedLength)
+            throw std::runtime_error(format("Buffer too small for directory %i entry %i", (int)file, (int)id));
+
+        length = decodedLength;
+        return output.subspan(0, decodedLength);
+    });
+
+    return length;
+}
+
+/**
+ * Objects are encrypted, unless the offset of the first object fits in the file.
+ */
+static void decodePlainFile(GameFile file, Span<uint8_t> data) {
+    if (file == GameFile::Objects && data.size() >= 2 && readUINT16LE(data.data()) > data.size())
+        decrypt(data.data(), data.size(), CRYPT_KEY_SIERRA, CRYPT_KEY_LENGTH);
+}
+
+std::vector<uint8_t> GameVolume::decodeRaw(GameFile file, Span<const uint8_t> raw) {
+    // Words and objects are plain files, they don't have a resource header.
+    if (file == GameFile::Words || file == GameFile::Objects) {
+        std::vector<uint8_t> buffer(raw.begin(), raw.end());
+
+        decodePlainFile(file, Span<uint8_t>(buffer.data(), buffer.size()));
         return buffer;
+    }
+
+    size_t headerSize = this->headerSize();
 
-    if (buffer[0] != 0x12 || buffer[1] != 0x34)
+    if (raw.size() < headerSize || raw[0] != 0x12 || raw[1] != 0x34)
         throw std::runtime_error("Invalid resource signature");
 
+    std::vector<uint8_t> buffer(readUINT16LE(raw.data() + 3));
+
+    decodePayload(file, raw.data(), raw.subspan(headerSize, raw.size() - headerSize), Span<uint8_t>(buffer.data(), buffer.size()));
     return buffer;
 }
 
-std::vector<uint8_t> GameVolume::loadV2(GameFile file, uint8_t id) {
-    std::vector<uint8_t> buffer(loadRaw(file, id));
-    uint16_t uncompressedLength = readUINT16LE(buffer.data() + 3);
+size_t GameVolume::headerSize() const {
+    return _info.version() >= 0x3000 ? 7 : 5;
+}
 
-    buffer.erase(buffer.begin(), buffer.begin() + 5);
+std::vector<GameVolumeLocation> GameVolume::sequentialOrder() const {
+    std::vector<GameVolumeLocation> locations;
 
-    if (buffer.size() != uncompressedLength)
-        buffer.resize(uncompressedLength);
+    for (size_t index = (size_t)GameFile::Logic; index <= (size_t)GameFile::Words; index++) {
+        GameFile file = (GameFile)index;
 
-    if (file == GameFile::Logic)
-        decryptLogic(buffer.data(), buffer.size(), CRYPT_KEY_SIERRA, CRYPT_KEY_LENGTH);
+        directory(file)->enumerate([&locations, file](uint8_t id, const GameVolumeEntry& entry) {
+            locations.push_back(GameVolumeLocation(file, id, entry));
+        });
+    }
 
-    return buffer;
+    std::sort(locations.begin(), locations.end(), [](const GameVolumeLocation& a, const GameVolumeLocation& b) {
+        if (a.entry.file() != b.entry.file())
+            return a.entry.file() < b.entry.file();
+
+        return a.entry.offset() < b.entry.offset();
+    });
+
+    return locations;
 }
 
-static void picExpand(const uint8_t* input, size_t inputLength, uint8_t* output, size_t outputLength) {
-    bool   dataOffsetNibble = false;
-    size_t dataOffset       = 0;
+void GameVolume::scan(const ScanCallback& callback, size_t windowSize) {
+    std::vector<GameVolumeLocation> locations(sequentialOrder());
+    const GameVolumeLocation* begin = locations.data();
+    const GameVolumeLocation* end   = begin + locations.size();
 
-    auto readByte = [input, &dataOffsetNibble, &dataOffset]() {
-        if (!dataOffsetNibble) {
-            return input[dataOffset++];
-        }
-        else {
-            uint8_t curByte = input[dataOffset++] << 4;
-            return (uint8_t)((input[dataOffset] >> 4) | curByte);
-        }
-    };
-
-    auto readNibble = [input, &dataOffsetNibble, &dataOffset]() {
-        if (!dataOffsetNibble) {
-            dataOffsetNibble = true;
-            return input[dataOffset] >> 4;
-        } else {
-            dataOffsetNibble = false;
-            return input[dataOffset++] & 0x0F;
-        }
-    };
+    while (begin != end) {
+        const GameVolumeLocation* next = begin;
+
+        while (next != end && next->entry.file() == begin->entry.file())
+            next++;
+
+        scanFile(begin->entry.file(), begin, next, callback, windowSize);
+        begin = next;
+    }
+}
 
-    while (dataOffset < inputLength) {
-        uint8_t curByte = readByte();
+void GameVolume::scanFile(GameFile volumeFile, const GameVolumeLocation* begin, const GameVolumeLocation* end, const ScanCallback& callback, size_t windowSize) {
+    const char*          fileName = _info.file(volumeFile).c_str();
+    std::vector<uint8_t> window;
+    size_t               windowOffset = 0;
+    size_t               fileSize     = _views[(size_t)volumeFile].size();
 
-        *output++ = curByte;
+    if (fileSize == 0) {
+        fileSize = _platform->fileSize(fileName);
+        if (fileSize == (size_t)-1)
+            throw std::runtime_error(format("Failed to determine size of volume %i", (int)volumeFile));
+    }
 
-        switch (curByte) {
-        case 0xf0:
-            *output++ = readNibble();
-            break;
-        case 0xf2:
-            *output++ = readNibble();
-            break;
-        case 0xff:
-            dataOffset = inputLength;
-            break;
+    for (const GameVolumeLocation* it = begin; it != end; it++) {
+        const GameVolumeEntry& e = it->entry;
+        Span<const uint8_t>    data(entryView(e));
+
+        if (data.empty() && e.length()) {
+            if (e.offset() < windowOffset || (e.offset() + e.length()) > (windowOffset + window.size())) {
+                if (e.offset() + e.length() > fileSize)
+                    throw std::runtime_error(format("Failed to read volume %i", (int)volumeFile));
+
+                windowOffset = e.offset();
+                window.resize(std::min(std::max(windowSize, e.length()), fileSize - windowOffset));
+
+                if (!_platform->fileRead(fileName, windowOffset, window.data(), window.size()))
+                    throw std::runtime_error(format("Failed to read volume %i", (int)volumeFile));
+            }
+
+            data = Span<const uint8_t>(window.data() + (e.offset() - windowOffset), e.length());
         }
+
+        std::vector<uint8_t> buffer(decodeRaw(it->type, data));
+
+        callback(it->type, it->id, buffer);
     }
 }
 
-std::vector<uint8_t> GameVolume::loadV3(GameFile file, uint8_t id) {
-    std::vector<uint8_t> buffer(loadRaw(file, id));
+void GameVolume::loadPlain(GameFile file, const GameVolumeEntry& e, Span<uint8_t> output) {
+    Span<const uint8_t> mapped(entryView(e));
+
+    if (!mapped.empty())
+        memcpy(output.data(), mapped.data(), mapped.size());
+    else if (!_platform->fileRead(_info.file(e.file()).c_str(), e.offset(), output.data(), e.length()))
+        throw std::runtime_error(format("Failed to read volume %i", (int)e.file()));
+
+    decodePlainFile(file, output);
+}
+
+Span<const uint8_t> GameVolume::view(GameFile file, uint8_t id) {
+    // Logic and objects are encrypted, they always need a private copy.
+    if (file == GameFile::Logic || file == GameFile::Objects)
+        return Span<const uint8_t>();
+
+    const auto& e = entry(file, id);
+    Span<const uint8_t> mapped(entryView(e));
+
+    if (mapped.empty() || file == GameFile::Words)
+        return mapped;
+
+    bool   version3   = _info.version() >= 0x3000;
+    size_t headerSize = version3 ? 7 : 5;
+
+    if (mapped.size() < headerSize || mapped[0] != 0x12 || mapped[1] != 0x34)
+        throw std::runtime_error("Invalid resource signature");
 
-    uint16_t flags              = buffer[2];
-    uint16_t uncompressedLength = readUINT16LE(buffer.data() + 3);
-    uint16_t compressedLength   = readUINT16LE(buffer.data() + 5);
+    uint16_t uncompressedLength = readUINT16LE(mapped.data() + 3);
 
-    if (compressedLength == uncompressedLength) {
-        buffer.erase(buffer.begin(), buffer.begin() + 7);
+    if (version3 && readUINT16LE(mapped.data() + 5) != uncompressedLength)
+        return Span<const uint8_t>();
 
-        if (buffer.size() != compressedLength)
-            buffer.resize(compressedLength);
+    if (uncompressedLength > (mapped.size() - headerSize))
+        return Span<const uint8_t>();
+
+    return mapped.subspan(headerSize, uncompressedLength);
+}
+
+/**
+ * Decodes the payload following a resource header into output, which must be
+ * exactly as long as the uncompressed length. The payload may be shorter than
+ * declared when the resource is truncated, the missing bytes read as zero.
+ */
+void GameVolume::decodePayload(GameFile file, const uint8_t* header, Span<const uint8_t> payload, Span<uint8_t> output) {
+    bool     version3           = _info.version() >= 0x3000;
+    uint16_t flags              = header[2];
+    uint16_t uncompressedLength = readUINT16LE(header + 3);
+    uint16_t storedLength       = version3 ? readUINT16LE(header + 5) : uncompressedLength;
+    size_t   inputLength        = std::min((size_t)storedLength, payload.size());
+
+    assert(output.size() == uncompressedLength);
+
+    if (storedLength == uncompressedLength) {
+        if (inputLength)
+            memcpy(output.data(), payload.data(), inputLength);
+
+        if (inputLength < output.size())
+            memset(output.data() + inputLength, 0, output.size() - inputLength);
 
         if (file == GameFile::Logic)
-            decryptLogic(buffer.data(), buffer.size(), CRYPT_KEY_SIERRA, CRYPT_KEY_LENGTH);
+            decryptLogic(output.data(), output.size(), CRYPT_KEY_SIERRA, CRYPT_KEY_LENGTH);
 
-        return buffer;
+        return;
     }
 
-    std::vector<uint8_t> uncompressedBuffer;
-
-    uncompressedBuffer.reserve(uncompressedLength + 32);
-    uncompressedBuffer.resize(uncompressedLength, 0);
-    buffer.resize(buffer.size() + 32);
+    if (!output.empty())
+        memset(output.data(), 0, output.size());
 
     if (file == GameFile::Picture && flags & 0x80)
-        picExpand(buffer.data() + 7, compressedLength, uncompressedBuffer.data(), uncompressedLength);
+        PictureExpand(payload.data(), inputLength, output.data(), output.size());
     else
-        LZWExpand(buffer.data() + 7, compressedLength, uncompressedBuffer.data(), uncompressedLength);
+        LZWExpand(payload.data(), inputLength, output.data(), output.size());
+}
 
-    return uncompressedBuffer;
+/**
+ * Per thread buffer receiving resources of unmapped volumes whose exact length is
+ * known. It only grows, so that loads stop allocating once it fits the largest
+ * resource.
+ */
+static std::vector<uint8_t>& scratchBuffer() {
+    static thread_local std::vector<uint8_t> buffer;
+    return buffer;
+}
+
+/**
+ * Copies the header of a resource into header, which must hold 7 bytes. When the
+ * payload is at hand too, because the volume is mapped or because the entry is
+ * exact and got read in one go into the scratch buffer, it is returned. Otherwise
+ * the returned span has no data and decodeResource() reads the payload itself.
+ */
+Span<const uint8_t> GameVolume::readHeader(const GameVolumeEntry& e, uint8_t* header) {
+    size_t              headerSize = this->headerSize();
+    Span<const uint8_t> raw(entryView(e));
+
+    if (raw.empty() && e.exact()) {
+        std::vector<uint8_t>& buffer = scratchBuffer();
+
+        buffer.resize(e.length());
+
+        if (!_platform->fileRead(_info.file(e.file()).c_str(), e.offset(), buffer.data(), buffer.size()))
+            throw std::runtime_error(format("Failed to read volume %i", (int)e.file()));
+
+        raw = Span<const uint8_t>(buffer.data(), buffer.size());
+    }
+
+    if (!raw.empty()) {
+        if (raw.size() < headerSize || raw[0] != 0x12 || raw[1] != 0x34)
+            throw std::runtime_error("Invalid resource signature");
+
+        memcpy(header, raw.data(), headerSize);
+        return raw.subspan(headerSize, raw.size() - headerSize);
+    }
+
+    if (e.length() < headerSize || !_platform->fileRead(_info.file(e.file()).c_str(), e.offset(), header, headerSize))
+        throw std::runtime_error(format("Failed to read volume %i", (int)e.file()));
+
+    if (header[0] != 0x12 || header[1] != 0x34)
+        throw std::runtime_error("Invalid resource signature");
+
+    return Span<const uint8_t>();
+}
+
+/**
+ * Decodes a resource whose header was fetched by readHeader(). A payload that is
+ * not in memory is read from the volume, and only as much of it as the header
+ * declares: uncompressed payloads are read straight into output, compressed ones
+ * are expanded while being read so that the compressed data is never held in
+ * full. The exact length of the resource is then recorded in the directory.
+ */
+void GameVolume::decodeResource(GameFile file, uint8_t id, const GameVolumeEntry& e, const uint8_t* header, Span<const uint8_t> payload, Span<uint8_t> output) {
+    if (payload.data()) {
+        decodePayload(file, header, payload, output);
+        return;
+    }
+
+    bool        version3           = _info.version() >= 0x3000;
+    size_t      headerSize         = this->headerSize();
+    const char* volumeFile         = _info.file(e.file()).c_str();
+    uint16_t    flags              = header[2];
+    uint16_t    uncompressedLength = readUINT16LE(header + 3);
+    uint16_t    storedLength       = version3 ? readUINT16LE(header + 5) : uncompressedLength;
+    size_t      inputLength        = std::min((size_t)storedLength, e.length() - headerSize);
+    size_t      inputOffset        = e.offset() + headerSize;
+
+    assert(output.size() == uncompressedLength);
+
+    if (storedLength == uncompressedLength) {
+        if (inputLength && !_platform->fileRead(volumeFile, inputOffset, output.data(), inputLength))
+            throw std::runtime_error(format("Failed to read volume %i", (int)e.file()));
+
+        if (inputLength < output.size())
+            memset(output.data() + inputLength, 0, output.size() - inputLength);
+
+        if (file == GameFile::Logic)
+            decryptLogic(output.data(), output.size(), CRYPT_KEY_SIERRA, CRYPT_KEY_LENGTH);
+    }
+    else {
+        bool               picture = file == GameFile::Picture && (flags & 0x80);
+        LZWStreamExpander& lzw     = LZWStreamExpander::threadLocal();
+        PictureExpander    nibbles;
+        uint8_t            chunk[4096];
+
+        if (!output.empty())
+            memset(output.data(), 0, output.size());
+
+        if (picture)
+            nibbles.reset(uncompressedLength);
+        else
+            lzw.reset(uncompressedLength);
+
+        for (size_t position = 0;;) {
+            size_t length = std::min(sizeof(chunk), inputLength - position);
+
+            if (length && !_platform->fileRead(volumeFile, inputOffset + position, chunk, length))
+                throw std::runtime_error(format("Failed to read volume %i", (int)e.file()));
+
+            Span<const uint8_t> input(chunk, length);
+            bool                last = (position += length) == inputLength;
+            bool                done = picture ? nibbles.expand(input, output, last) : lzw.expand(input, output, last);
+
+            if (done || last)
+                break;
+        }
+    }
+
+    directory(file)->refine(id, headerSize + inputLength);
 }
 
 const GameVolumeEntry& GameVolume::entry(GameFile file, uint8_t id) const {
-    if (_entries.count(file) == 0)
+    const GameVolumeDirectory* dir = directory(file);
+    if (!dir)
         throw std::runtime_error(format("Directory %i does not exists", (int)file));
 
-    const auto& map = _entries.at(file);
-    if (map.count(id) == 0)
+    if (!dir->exists(id))
         throw std::runtime_error(format("Directory %i Entry %i does not exists", (int)file, (int)id));
 
-    return map.at(id);
+    return dir->entry(id);
+}
+
+Span<const uint8_t> GameVolume::entryView(const GameVolumeEntry& e) const {
+    const Span<const uint8_t>& mapped = _views[(size_t)e.file()];
+
+    if (mapped.empty() || e.offset() > mapped.size() || e.length() > (mapped.size() - e.offset()))
+        return Span<const uint8_t>();
+
+    return mapped.subspan(e.offset(), e.length());
 }
@@ -10,24 +10,128 @@
 
 #include "AGIResources.hpp"
 #include "GameInfo.hpp"
+#include "GameVolumeCache.hpp"
+#include "GameVolumeLoader.hpp"
+#include "MemoryResource.hpp"
+#include "Span.hpp"
+
+#include <atomic>
 
 namespace AGI { namespace Resources {
 
+    class GameVolumeIndex;
+
+    /**
+     * Location of a resource, packed in 8 bytes: the file it is stored in, a 24 bits
+     * offset and a 32 bits length. The length inferred from the directory may span
+     * gaps and leftovers up to the next resource; once a load has read the resource
+     * header the entry is refined to the exact length and flagged as such.
+     *
+     * The packed value is atomic so that a refinement can race with readers.
+     * Offsets and lengths past MaximumOffset and MaximumLength don't fit, callers
+     * must reject them before building an entry.
+     */
     class GameVolumeEntry
     {
     private:
-        GameFile _file;
-        size_t   _offset;
-        size_t   _length;
+        static const uint64_t ExactFlag = 1ull << 63;
+
+        std::atomic<uint64_t> _packed;
 
     public:
-        inline GameVolumeEntry(GameFile file, size_t offset, size_t length) : _file(file), _offset(offset), _length(length) {
+        static const size_t MaximumOffset = 0xffffff;
+        static const size_t MaximumLength = 0xffffffff;
+
+    public:
+        inline GameVolumeEntry() : _packed(0) {
         }
 
+        inline GameVolumeEntry(GameFile file, size_t offset, size_t length, bool exact = false) : _packed((exact ? ExactFlag : 0) | ((uint64_t)file << 56) | ((uint64_t)offset << 32) | (uint64_t)length) {
+            assert(offset <= MaximumOffset);
+            assert(length <= MaximumLength);
+        }
+
+        inline GameVolumeEntry(const GameVolumeEntry& other) : _packed(other.packed()) {
+        }
+
+        inline GameVolumeEntry& operator = (const GameVolumeEntry& other) {
+            _packed.store(other.packed(), std::memory_order_relaxed);
+            return *this;
+        }
+
+    public:
+        inline GameFile file()   const { return (GameFile)((packed() >> 56) & 0x7f); }
+        inline size_t   offset() const { return (size_t)((packed() >> 32) & 0xffffff); }
+        inline size_t   length() const { return (size_t)(packed() & 0xffffffff); }
+        inline bool     exact()  const { return (packed() & ExactFlag) != 0; }
+
+        /**
+         * Records the exact length of the resource. The length can only shrink, a
+         * refinement never makes the entry cover more than it did.
+         */
+        inline void refine(size_t exactLength) {
+            uint64_t packed = this->packed();
+
+            if (exactLength > (packed & 0xffffffff))
+                return;
+
+            _packed.store((packed & ~0xffffffffull) | ExactFlag | (uint64_t)exactLength, std::memory_order_relaxed);
+        }
+
+    private:
+        inline uint64_t packed() const { return _packed.load(std::memory_order_relaxed); }
+    };
+
+    /**
+     * A resource's identity along with its location.
+     */
+    class GameVolumeLocation
+    {
     public:
-        inline GameFile file()   const { return _file; }
-        inline size_t   offset() const { return _offset; }
-        inline size_t   length() const { return _length; }
+        GameFile        type;
+        uint8_t         id;
+        GameVolumeEntry entry;
+
+    public:
+        inline GameVolumeLocation(GameFile t, uint8_t i, const GameVolumeEntry& e) : type(t), id(i), entry(e) {
+        }
+    };
+
+    /**
+     * Dense table of the 256 possible entries of one resource type, with a bitmap
+     * telling which ones exist.
+     */
+    class GameVolumeDirectory
+    {
+    private:
+        uint64_t        _present[4];
+        GameVolumeEntry _entries[256];
+
+    public:
+        inline GameVolumeDirectory() {
+            _present[0] = _present[1] = _present[2] = _present[3] = 0;
+        }
+
+    public:
+        inline bool exists(uint8_t id) const { return (_present[id >> 6] >> (id & 63)) & 1; }
+        inline const GameVolumeEntry& entry(uint8_t id) const { return _entries[id]; }
+
+        inline void refine(uint8_t id, size_t exactLength) {
+            _entries[id].refine(exactLength);
+        }
+
+        inline void set(uint8_t id, const GameVolumeEntry& entry) {
+            _entries[id] = entry;
+            _present[id >> 6] |= 1ull << (id & 63);
+        }
+
+        template<typename Lambda>
+        void enumerate(const Lambda& lambda) const {
+            for (int id = 0; id < 256; id++) {
+                if (exists((uint8_t)id))
+                    lambda((uint8_t)id, _entries[id]);
+            }
+        }
     };
 
     /**
@@ -38,54 +142,213 @@ namespace AGI { namespace Resources {
      * It abstracts:
      *   1. Compression
      *   2. Encryption
+     *
+     * The directory of each resource type is parsed on first use, under a once flag,
+     * and volume files are sized and mapped once when the first volume directory is
+     * parsed. Afterward only the lengths of the entries are refined, atomically, as
+     * resources get loaded. So load(), loadShared(), view(), exists(), enumerate()
+     * and the cache functions can be called from several threads at once on the same
+     * volume. The platform abstraction layer must support concurrent reads for this
+     * to hold, the POSIX based ones do. Loads from a mapped volume never go through
+     * the platform abstraction layer again.
      */
     class GameVolume
     {
+    public:
+        friend class GameVolumeIndex;
+
+    private:
+        typedef std::unordered_map<GameFile, size_t> volume_sizes_t;
+
+        static const size_t DirectoryCount = (size_t)GameFile::Words - (size_t)GameFile::Logic + 1;
+
     private:
         std::unique_ptr<PlatformAbstractionLayer> _platform;
         GameInfo                                  _info;
 
-        std::unordered_map<GameFile, std::unordered_map<int, GameVolumeEntry>> _entries;
+        GameVolumeDirectory                       _directories[DirectoryCount];
+        mutable std::once_flag                    _directoryOnce[DirectoryCount];
+        std::once_flag                            _volumesOnce;
+        volume_sizes_t                            _volumeSizes;
 
-    private:
-        typedef std::unordered_map<GameFile, size_t> volume_sizes_t;
+        GameVolumeCache                           _cache;
+        Span<const uint8_t>                       _views[(size_t)GameFile::Words + 1];
+
+        // Declared last so that its workers are stopped before anything they use
+        // is destroyed.
+        std::once_flag                            _loaderOnce;
+        std::unique_ptr<GameVolumeLoader>         _loader;
+
+    public:
+        typedef std::function<void(GameFile file, uint8_t id, std::vector<uint8_t>& data)> ScanCallback;
 
     public:
         GameVolume(PlatformAbstractionLayer* platform);
         GameVolume(const GameInfo& info, PlatformAbstractionLayer* platform);
 
+        /**
+         * Restores the game information and directory from the given index file when
+         * it is still valid for the game files. Otherwise detects the game, parses
+         * the directory as usual and then tries to write a fresh index.
+         */
+        GameVolume(PlatformAbstractionLayer* platform, const char* indexFileName);
+
+        /**
+         * Writes the game information and directory to an index file, along with the
+         * exact lengths that loads have found so far. Returns false on failure.
+         */
+        bool writeIndex(const char* indexFileName) const;
+
         std::vector<uint8_t> load(GameFile file, uint8_t id);
 
+        /**
+         * Decodes the resource into memory drawn from the given resource, typically a
+         * MonotonicBufferResource shared by a whole batch. The cache is neither
+         * consulted nor filled.
+         */
+        MemoryBuffer load(GameFile file, uint8_t id, MemoryResource& memory);
+
+        /**
+         * Returns the length of the resource once decoded, reading only its header.
+         */
+        size_t decodedSize(GameFile file, uint8_t id);
+
+        /**
+         * Decodes the resource into the caller's buffer, which must be at least
+         * decodedSize() bytes long, and returns the decoded length. Decryption and
+         * decompression write to the buffer directly, with scratch space kept per
+         * thread, so that repeated loads do not allocate. The cache is consulted but
+         * not filled.
+         */
+        size_t loadInto(GameFile file, uint8_t id, Span<uint8_t> output);
+
+        /**
+         * Loads several resources at once, returning them in the order they were
+         * requested. Requests are sorted by volume and offset and ranges that are
+         * adjacent or close to each other are fetched with a single read, then every
+         * resource is decoded out of that shared buffer.
+         */
+        std::vector<std::vector<uint8_t>> loadBatch(Span<const std::pair<GameFile, uint8_t>> requests);
+
+        /**
+         * Same as load(), but the decoded resource is shared with the cache instead
+         * of being copied. Resources are only kept once a cache budget is set with
+         * setCacheBudget(), or when they are pinned.
+         */
+        GameResource loadShared(GameFile file, uint8_t id);
+
+        /**
+         * Loads a resource and keeps it in the cache until it is unpinned, regardless
+         * of the cache budget.
+         */
+        GameResource pin(GameFile file, uint8_t id);
+        void unpin(GameFile file, uint8_t id);
+
+        void setCacheBudget(size_t bytes);
+
+        /**
+         * Queues a load on a background worker and returns immediately. The workers
+         * are started on the first call. The resource goes through loadShared(), so
+         * it lands in the cache when the budget allows it.
+         */
+        GameLoadRequest loadAsync(GameFile file, uint8_t id, GameLoadPriority priority = GameLoadPriority::Normal);
+
+        /**
+         * Queues a low priority load whose only purpose is to warm the cache ahead of
+         * time. Has no effect on resources that would not be kept by the cache.
+         */
+        void prefetch(GameFile file, uint8_t id);
+
+        /**
+         * Cancels every background load that has not started yet.
+         */
+        void cancelPendingLoads();
+
+        /**
+         * Returns the resource's content straight out of the platform's file mapping,
+         * without any copy. Only resources stored uncompressed and unencrypted can be
+         * viewed this way; for the others, or when the platform cannot map files, an
+         * empty view is returned and load() must be used instead.
+         */
+        Span<const uint8_t> view(GameFile file, uint8_t id);
+
         bool exists(GameFile file, uint8_t id) const;
 
         template<typename Lambda>
         void enumerate(const Lambda& lambda) {
-            for (const auto& file : _entries) {
-                for (const auto& entry : file.second)
-                    lambda(*this, file.first, entry.first, entry.second.length());
+            for (size_t index = (size_t)GameFile::Logic; index <= (size_t)GameFile::Words; index++) {
+                GameFile file = (GameFile)index;
+
+                directory(file)->enumerate([this, file, &lambda](uint8_t id, const GameVolumeEntry& entry) {
+                    lambda(*this, file, id, entry.length());
+                });
             }
         }
 
+        /**
+         * Same as enumerate(), but resources are visited in the order they are stored
+         * on disk: by volume, then by offset. Loading them in that order reads every
+         * volume front to back instead of seeking back and forth between them.
+         */
+        template<typename Lambda>
+        void enumerateSequential(const Lambda& lambda) {
+            for (const auto& location : sequentialOrder())
+                lambda(*this, location.type, location.id, location.entry.length());
+        }
+
+        /**
+         * Decodes every resource of the game in a single pass over each volume. A
+         * volume that is not mapped is read front to back in windows of at least
+         * windowSize bytes, and its resources are decoded out of the window in
+         * memory. The cache is neither consulted nor filled.
+         */
+        void scan(const ScanCallback& callback, size_t windowSize = 1024 * 1024);
+
     public:
         inline PlatformAbstractionLayer& platform() const { return *_platform.get(); }
         inline const GameInfo& info() const { return _info; }
+        inline const GameVolumeCache& cache() const { return _cache; }
 
     private:
-        void parseDirectory();
-        void parseDirectoryV2();
-        void parseDirectoryV3();
-        void parseObjectsAndWordsEntries();
+        GameVolume(PlatformAbstractionLayer* platform, std::unique_ptr<GameVolumeIndex>&& index, const char* indexFileName);
+
+        void restoreDirectory(const GameVolumeIndex& index);
+        void parseDirectory(GameFile file);
+        void parseDirectoryV3(GameFile file);
+        void parsePlainFileEntry(GameFile file);
 
         void loadDirectoryV2(GameFile file, const volume_sizes_t& volumeSizes);
-        void loadDirectoryV3(GameFile file, uint8_t* offsets, size_t length, const volume_sizes_t& volumeSizes);
+        void loadDirectoryV3(GameFile file, const uint8_t* offsets, size_t length, const volume_sizes_t& volumeSizes);
 
-        std::vector<uint8_t> loadV2(GameFile file, uint8_t id);
-        std::vector<uint8_t> loadV3(GameFile file, uint8_t id);
-        std::vector<uint8_t> loadRaw(GameFile file, uint8_t id);
+        std::vector<uint8_t> decode(GameFile file, uint8_t id);
+        std::vector<uint8_t> decodeRaw(GameFile file, Span<const uint8_t> raw);
+        template<typename Allocate>
+        void                 decodeWith(GameFile file, uint8_t id, const Allocate& allocate);
+        void                 decodePayload(GameFile file, const uint8_t* header, Span<const uint8_t> payload, Span<uint8_t> output);
+        void                 decodeResource(GameFile file, uint8_t id, const GameVolumeEntry& e, const uint8_t* header, Span<const uint8_t> payload, Span<uint8_t> output);
+        Span<const uint8_t>  readHeader(const GameVolumeEntry& e, uint8_t* header);
+        void                 loadPlain(GameFile file, const GameVolumeEntry& e, Span<uint8_t> output);
+        size_t               headerSize() const;
+        void                 scanFile(GameFile volumeFile, const GameVolumeLocation* begin, const GameVolumeLocation* end, const ScanCallback& callback, size_t windowSize);
+        std::vector<GameVolumeLocation> sequentialOrder() const;
+        Span<const uint8_t> readDirectory(const std::string& fileName, std::vector<uint8_t>& storage);
 
+        const volume_sizes_t& volumes();
         volume_sizes_t gatherVolumeSizes();
 
         const GameVolumeEntry& entry(GameFile file, uint8_t id) const;
+        GameVolumeLoader& loader();
+
+        /**
+         * Returns the directory of the given type, parsing it on first use.
+         */
+        const GameVolumeDirectory* directory(GameFile file) const;
+
+        inline GameVolumeDirectory* directory(GameFile file) {
+            return const_cast<GameVolumeDirectory*>(static_cast<const GameVolume*>(this)->directory(file));
+        }
+
+        Span<const uint8_t> entryView(const GameVolumeEntry& entry) const;
     };
 
 }}
@@ -0,0 +1,151 @@
+//
+//  GameVolumeCache.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "GameVolumeCache.hpp"
+
+using namespace AGI::Resources;
+
+static inline uint16_t cacheKey(GameFile file, uint8_t id) {
+    return (uint16_t)(((uint16_t)file << 8) | id);
+}
+
+GameVolumeCache::GameVolumeCache(size_t budget) : _budget(budget), _count(0), _size(0), _hits(0), _misses(0), _evictions(0) {
+}
+
+GameResource GameVolumeCache::find(GameFile file, uint8_t id) {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto it(_index.find(cacheKey(file, id)));
+    if (it == _index.end()) {
+        _misses++;
+        return nullptr;
+    }
+
+    _hits++;
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return it->second->resource;
+}
+
+GameResource GameVolumeCache::findAndPin(GameFile file, uint8_t id) {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto it(_index.find(cacheKey(file, id)));
+    if (it == _index.end()) {
+        _misses++;
+        return nullptr;
+    }
+
+    _hits++;
+    it->second->pinned = true;
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return it->second->resource;
+}
+
+GameResource GameVolumeCache::insert(GameFile file, uint8_t id, const GameResource& resource, bool pin) {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    uint16_t key = cacheKey(file, id);
+    auto     it(_index.find(key));
+
+    if (it != _index.end()) {
+        // Someone else decoded it first, keep the existing copy.
+        it->second->pinned |= pin;
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return it->second->resource;
+    }
+
+    if (!pin && resource->size() > _budget)
+        return resource;
+
+    _entries.push_front(Entry());
+    _entries.front().key      = key;
+    _entries.front().resource = resource;
+    _entries.front().pinned   = pin;
+    _index.emplace(key, _entries.begin());
+    _size += resource->size();
+    _count = _entries.size();
+
+    evict();
+    return resource;
+}
+
+bool GameVolumeCache::setPinned(GameFile file, uint8_t id, bool pinned) {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto it(_index.find(cacheKey(file, id)));
+    if (it == _index.end())
+        return false;
+
+    it->second->pinned = pinned;
+
+    if (!pinned)
+        evict();
+
+    return true;
+}
+
+void GameVolumeCache::setBudget(size_t budget) {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _budget = budget;
+    evict();
+}
+
+void GameVolumeCache::clear() {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _entries.clear();
+    _index.clear();
+    _size  = 0;
+    _count = 0;
+}
+
+void GameVolumeCache::evict() {
+    auto it(_entries.end());
+
+    while (_size > _budget && it != _entries.begin()) {
+        --it;
+
+        if (it->pinned)
+            continue;
+
+        _size -= it->resource->size();
+        _index.erase(it->key);
+        it = _entries.erase(it);
+        _evictions++;
+    }
+
+    _count = _entries.size();
+}
+
+size_t GameVolumeCache::budget() const {
+    return _budget;
+}
+
+size_t GameVolumeCache::size() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _size;
+}
+
+size_t GameVolumeCache::count() const {
+    return _count;
+}
+
+size_t GameVolumeCache::hits() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _hits;
+}
+
+size_t GameVolumeCache::misses() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _misses;
+}
+
+size_t GameVolumeCache::evictions() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _evictions;
+}
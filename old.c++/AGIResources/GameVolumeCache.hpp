@@ -0,0 +1,87 @@
+//
+//  GameVolumeCache.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__GameVolumeCache_hpp__
+#define __AGIResources__GameVolumeCache_hpp__
+
+#include "AGIResources.hpp"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Decoded resources, shared between every user of a cache. They are never
+     * modified once they have been decoded.
+     */
+    typedef std::shared_ptr<const std::vector<uint8_t>> GameResource;
+
+    /**
+     * Least recently used cache of decoded resources, bounded by a budget in bytes.
+     * Pinned resources are never evicted, but still count against the budget.
+     * A budget of 0 disables caching of anything that is not pinned.
+     */
+    class GameVolumeCache
+    {
+    private:
+        class Entry {
+        public:
+            uint16_t     key;
+            GameResource resource;
+            bool         pinned;
+        };
+
+        mutable std::mutex                                         _lock;
+        std::atomic<size_t>                                        _budget;
+        std::atomic<size_t>                                        _count;
+        size_t                                                     _size;
+        std::list<Entry>                                           _entries;
+        std::unordered_map<uint16_t, std::list<Entry>::iterator>   _index;
+        size_t                                                     _hits;
+        size_t                                                     _misses;
+        size_t                                                     _evictions;
+
+    public:
+        GameVolumeCache(size_t budget = 0);
+
+    public:
+        GameResource find(GameFile file, uint8_t id);
+
+        /**
+         * Same as find(), but pins the resource when it is found, under the same
+         * lock so that it cannot be evicted in between.
+         */
+        GameResource findAndPin(GameFile file, uint8_t id);
+
+        GameResource insert(GameFile file, uint8_t id, const GameResource& resource, bool pin);
+        bool setPinned(GameFile file, uint8_t id, bool pinned);
+        void setBudget(size_t budget);
+        void clear();
+
+    public:
+        /**
+         * True when nothing is cached and nothing would be, checked without locking.
+         */
+        inline bool bypassed() const { return _budget == 0 && _count == 0; }
+
+    public:
+        size_t budget() const;
+        size_t size() const;
+        size_t count() const;
+        size_t hits() const;
+        size_t misses() const;
+        size_t evictions() const;
+
+    private:
+        void evict();
+    };
+
+}}
+
+#endif /* __AGIResources__GameVolumeCache_hpp__ */
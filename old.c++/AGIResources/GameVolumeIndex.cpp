@@ -0,0 +1,224 @@
+//
+//  GameVolumeIndex.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "GameVolumeIndex.hpp"
+
+#include "PlatformAbstractionLayer.hpp"
+
+using namespace AGI::Resources;
+
+const char* GameVolumeIndex::DefaultFileName = ".agiresources.idx";
+
+static const uint8_t indexMagic[4] = { 'A', 'G', 'I', 'X' };
+
+// Set in the length of entries whose length is exact.
+static const uint32_t ExactLengthFlag = 0x80000000;
+
+// Type, id, file, offset and length of a directory entry.
+static const size_t EntrySize = 1 + 1 + 1 + 4 + 4;
+
+class GameVolumeIndexWriter {
+public:
+    std::vector<uint8_t> data;
+
+public:
+    void put(uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++)
+            data.push_back((uint8_t)(value >> (i * 8)));
+    }
+
+    void put(const std::string& value) {
+        if (value.length() > 0xffff)
+            throw std::runtime_error("String too long for the resource index");
+
+        put(value.length(), 2);
+        data.insert(data.end(), value.begin(), value.end());
+    }
+};
+
+class GameVolumeIndexReader {
+private:
+    Span<const uint8_t> _data;
+    size_t              _offset;
+
+public:
+    GameVolumeIndexReader(const Span<const uint8_t>& data) : _data(data), _offset(0) {
+    }
+
+    uint64_t get(size_t bytes) {
+        if (bytes > (_data.size() - _offset))
+            throw std::runtime_error("Truncated resource index");
+
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++)
+            value |= ((uint64_t)_data[_offset++]) << (i * 8);
+
+        return value;
+    }
+
+    std::string getString() {
+        size_t length = (size_t)get(2);
+        if (length > (_data.size() - _offset))
+            throw std::runtime_error("Truncated resource index");
+
+        std::string value((const char*)_data.data() + _offset, length);
+        _offset += length;
+        return value;
+    }
+
+    inline size_t remaining() const { return _data.size() - _offset; }
+    inline bool   atEnd()     const { return _offset == _data.size(); }
+};
+
+GameVolumeIndex::GameVolumeIndex(const GameInfo& info) : _info(info) {
+}
+
+std::unique_ptr<GameVolumeIndex> GameVolumeIndex::read(PlatformAbstractionLayer& platform, const char* fileName) {
+    try {
+        if (!platform.fileExists(fileName))
+            return nullptr;
+
+        size_t fileSize = platform.fileSize(fileName);
+        if (fileSize == (size_t)-1)
+            return nullptr;
+
+        std::vector<uint8_t> storage;
+        Span<const uint8_t>  data(platform.fileView(fileName, 0, fileSize));
+
+        if (data.empty()) {
+            storage.resize(fileSize);
+            if (!platform.fileRead(fileName, 0, storage.data(), fileSize))
+                return nullptr;
+
+            data = Span<const uint8_t>(storage.data(), storage.size());
+        }
+
+        GameVolumeIndexReader reader(data);
+
+        for (size_t i = 0; i < sizeof(indexMagic); i++) {
+            if (reader.get(1) != indexMagic[i])
+                return nullptr;
+        }
+
+        if (reader.get(4) != FormatVersion)
+            return nullptr;
+
+        std::string code(reader.getString());
+        std::string description(reader.getString());
+        uint32_t    version = (uint32_t)reader.get(4);
+        uint32_t    flags   = (uint32_t)reader.get(4);
+
+        std::unordered_map<GameFile, std::string> files;
+        size_t fileCount = (size_t)reader.get(1);
+
+        for (size_t i = 0; i < fileCount; i++) {
+            GameFile    file = (GameFile)reader.get(1);
+            std::string name(reader.getString());
+            size_t      size = (size_t)reader.get(8);
+            int64_t     modificationTime = (int64_t)reader.get(8);
+
+            if (platform.fileSize(name.c_str()) != size || platform.fileModificationTime(name.c_str()) != modificationTime)
+                return nullptr;
+
+            files.emplace(file, name);
+        }
+
+        std::unique_ptr<GameVolumeIndex> index(new GameVolumeIndex(GameInfo(code, description, version, flags, files)));
+        size_t entryCount = (size_t)reader.get(4);
+
+        if (entryCount > reader.remaining() / EntrySize)
+            return nullptr;
+
+        index->_entries.reserve(entryCount);
+
+        for (size_t i = 0; i < entryCount; i++) {
+            GameFile type   = (GameFile)reader.get(1);
+            uint8_t  id     = (uint8_t)reader.get(1);
+            GameFile file   = (GameFile)reader.get(1);
+            size_t   offset = (size_t)reader.get(4);
+            uint32_t length = (uint32_t)reader.get(4);
+
+            if (files.count(file) == 0 || offset > GameVolumeEntry::MaximumOffset)
+                return nullptr;
+
+            index->_entries.push_back(GameVolumeIndexEntry(type, id, GameVolumeEntry(file, offset, length & ~ExactLengthFlag, (length & ExactLengthFlag) != 0)));
+        }
+
+        if (!reader.atEnd())
+            return nullptr;
+
+        return index;
+    }
+    catch (const std::exception& ex) {
+        platform.log("Ignoring resource index %s: %s", fileName, ex.what());
+        return nullptr;
+    }
+}
+
+bool GameVolumeIndex::write(PlatformAbstractionLayer& platform, const char* fileName, const GameVolume& volume) {
+    try {
+        return writeUnchecked(platform, fileName, volume);
+    }
+    catch (const std::exception& ex) {
+        platform.log("Not writing resource index %s: %s", fileName, ex.what());
+        return false;
+    }
+}
+
+bool GameVolumeIndex::writeUnchecked(PlatformAbstractionLayer& platform, const char* fileName, const GameVolume& volume) {
+    GameVolumeIndexWriter writer;
+    const GameInfo&       info = volume.info();
+
+    writer.data.insert(writer.data.end(), indexMagic, indexMagic + sizeof(indexMagic));
+    writer.put(FormatVersion, 4);
+
+    writer.put(info.code());
+    writer.put(info.description());
+    writer.put(info.version(), 4);
+    writer.put(info.flags(), 4);
+
+    std::vector<GameFile> files;
+
+    for (size_t file = 0; file <= (size_t)GameFile::Words; file++) {
+        if (info.hasFile((GameFile)file))
+            files.push_back((GameFile)file);
+    }
+
+    writer.put(files.size(), 1);
+
+    for (GameFile file : files) {
+        const std::string& name = info.file(file);
+
+        writer.put((uint8_t)file, 1);
+        writer.put(name);
+        writer.put((uint64_t)platform.fileSize(name.c_str()), 8);
+        writer.put((uint64_t)platform.fileModificationTime(name.c_str()), 8);
+    }
+
+    std::vector<GameVolumeIndexEntry> entries;
+
+    for (size_t type = (size_t)GameFile::Logic; type <= (size_t)GameFile::Words; type++) {
+        volume.directory((GameFile)type)->enumerate([&entries, type](uint8_t id, const GameVolumeEntry& entry) {
+            entries.push_back(GameVolumeIndexEntry((GameFile)type, id, entry));
+        });
+    }
+
+    writer.put(entries.size(), 4);
+
+    for (const auto& entry : entries) {
+        writer.put((uint8_t)entry.type, 1);
+        writer.put(entry.id, 1);
+        writer.put((uint8_t)entry.entry.file(), 1);
+        if (entry.entry.length() & ExactLengthFlag)
+            throw std::runtime_error("Resource too long for the resource index");
+
+        writer.put(entry.entry.offset(), 4);
+        writer.put(entry.entry.length() | (entry.entry.exact() ? ExactLengthFlag : 0), 4);
+    }
+
+    return platform.fileWrite(fileName, writer.data.data(), writer.data.size());
+}
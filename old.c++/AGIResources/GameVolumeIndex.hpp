@@ -0,0 +1,78 @@
+//
+//  GameVolumeIndex.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__GameVolumeIndex_hpp__
+#define __AGIResources__GameVolumeIndex_hpp__
+
+#include "GameVolume.hpp"
+
+namespace AGI { namespace Resources {
+
+    class GameVolumeIndexEntry
+    {
+    public:
+        GameFile        type;
+        uint8_t         id;
+        GameVolumeEntry entry;
+
+    public:
+        inline GameVolumeIndexEntry(GameFile t, uint8_t i, const GameVolumeEntry& e) : type(t), id(i), entry(e) {
+        }
+    };
+
+    /**
+     * Compact binary sidecar file, holding the detected GameInfo and every directory
+     * entry of a game. It records the size and modification time of each game file,
+     * a stale index is simply ignored.
+     *
+     * Layout (little endian):
+     *   "AGIX", u32 format version
+     *   GameInfo: string code, string description, u32 version, u32 flags
+     *   u8 file count, then for each: u8 GameFile, string name, u64 size, i64 modification time in nanoseconds
+     *   u32 entry count, then for each: u8 type, u8 id, u8 GameFile, u32 offset, u32 length
+     *
+     * Strings are stored as an u16 length followed by the characters. The top bit of
+     * an entry's length is set when the length is exact rather than inferred.
+     */
+    class GameVolumeIndex
+    {
+    public:
+        enum {
+            FormatVersion = 2
+        };
+
+        static const char* DefaultFileName;
+
+    private:
+        GameInfo                          _info;
+        std::vector<GameVolumeIndexEntry> _entries;
+
+    private:
+        GameVolumeIndex(const GameInfo& info);
+
+    public:
+        inline const GameInfo&                          info()    const { return _info; }
+        inline const std::vector<GameVolumeIndexEntry>& entries() const { return _entries; }
+
+    public:
+        /**
+         * Returns null when the index does not exists, is corrupted, or does not match
+         * the game files anymore. Never throws.
+         */
+        static std::unique_ptr<GameVolumeIndex> read(PlatformAbstractionLayer& platform, const char* fileName);
+        /**
+         * Returns false when the index could not be written. Never throws.
+         */
+        static bool write(PlatformAbstractionLayer& platform, const char* fileName, const GameVolume& volume);
+
+    private:
+        static bool writeUnchecked(PlatformAbstractionLayer& platform, const char* fileName, const GameVolume& volume);
+    };
+
+}}
+
+#endif /* __AGIResources__GameVolumeIndex_hpp__ */
@@ -0,0 +1,118 @@
+//
+//  GameVolumeLoader.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "GameVolumeLoader.hpp"
+
+#include "GameVolume.hpp"
+
+using namespace AGI::Resources;
+
+bool GameLoadRequest::cancel() {
+    if (!_state)
+        return false;
+
+    std::lock_guard<std::mutex> guard(_state->lock);
+    if (_state->status != State::Queued)
+        return false;
+
+    _state->status = State::Cancelled;
+    _state->promise.set_exception(std::make_exception_ptr(std::runtime_error("Resource load cancelled")));
+    return true;
+}
+
+GameVolumeLoader::GameVolumeLoader(GameVolume& volume, size_t threadCount) : _volume(volume), _sequence(0), _stopping(false) {
+    if (threadCount == 0)
+        threadCount = 1;
+
+    _threads.reserve(threadCount);
+
+    for (size_t i = 0; i < threadCount; i++)
+        _threads.push_back(std::thread([this]() { run(); }));
+}
+
+GameVolumeLoader::~GameVolumeLoader() {
+    cancelAll();
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stopping = true;
+    }
+
+    _condition.notify_all();
+
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+GameLoadRequest GameVolumeLoader::enqueue(GameFile file, uint8_t id, GameLoadPriority priority) {
+    GameLoadRequest request;
+
+    request._state  = std::make_shared<GameLoadRequest::State>();
+    request._future = request._state->promise.get_future().share();
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _queue.push(Item { file, id, priority, _sequence++, request._state });
+    }
+
+    _condition.notify_one();
+    return request;
+}
+
+void GameVolumeLoader::cancelAll() {
+    std::priority_queue<Item> queue;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        std::swap(queue, _queue);
+    }
+
+    for (; !queue.empty(); queue.pop()) {
+        GameLoadRequest request;
+
+        request._state = queue.top().state;
+        request.cancel();
+    }
+}
+
+void GameVolumeLoader::run() {
+    for (;;) {
+        Item item;
+
+        {
+            std::unique_lock<std::mutex> guard(_lock);
+            _condition.wait(guard, [this]() { return _stopping || !_queue.empty(); });
+
+            if (_queue.empty())
+                return;
+
+            item = _queue.top();
+            _queue.pop();
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(item.state->lock);
+            if (item.state->status != GameLoadRequest::State::Queued)
+                continue;
+
+            item.state->status = GameLoadRequest::State::Running;
+        }
+
+        try {
+            GameResource resource(_volume.loadShared(item.file, item.id));
+
+            std::lock_guard<std::mutex> guard(item.state->lock);
+            item.state->status = GameLoadRequest::State::Done;
+            item.state->promise.set_value(resource);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> guard(item.state->lock);
+            item.state->status = GameLoadRequest::State::Done;
+            item.state->promise.set_exception(std::current_exception());
+        }
+    }
+}
@@ -0,0 +1,139 @@
+//
+//  GameVolumeLoader.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__GameVolumeLoader_hpp__
+#define __AGIResources__GameVolumeLoader_hpp__
+
+#include "AGIResources.hpp"
+#include "GameVolumeCache.hpp"
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Order in which queued loads are served. Requests of the same priority are
+     * served in the order they were queued.
+     */
+    enum class GameLoadPriority: uint8_t {
+        Prefetch,
+        Normal,
+        Urgent,
+    };
+
+    /**
+     * Handle on a load queued with GameVolume::loadAsync(). Copies of a handle refer
+     * to the same load.
+     */
+    class GameLoadRequest
+    {
+    public:
+        friend class GameVolumeLoader;
+
+    private:
+        class State {
+        public:
+            enum Status {
+                Queued,
+                Running,
+                Done,
+                Cancelled,
+            };
+
+            std::mutex                 lock;
+            Status                     status;
+            std::promise<GameResource> promise;
+
+        public:
+            inline State() : status(Queued) {
+            }
+        };
+
+        std::shared_ptr<State>           _state;
+        std::shared_future<GameResource> _future;
+
+    public:
+        inline GameLoadRequest() {
+        }
+
+    public:
+        inline bool valid() const { return _future.valid(); }
+        inline bool ready() const { return _future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+        inline const std::shared_future<GameResource>& future() const { return _future; }
+
+        /**
+         * Waits for the load to complete. Rethrows the load's exception, or throws
+         * when the request was cancelled.
+         */
+        inline GameResource get() const { return _future.get(); }
+
+        /**
+         * Cancels the load if no worker has started it yet. Returns false when it is
+         * too late, in which case the load completes normally.
+         */
+        bool cancel();
+    };
+
+    /**
+     * Small pool of worker threads loading resources of a volume in the background.
+     * Each worker reads and decodes a resource on its own, so while one of them waits
+     * on the platform another one is expanding, and the caller's thread never blocks.
+     */
+    class GameVolumeLoader
+    {
+    private:
+        class Item {
+        public:
+            GameFile                                file;
+            uint8_t                                 id;
+            GameLoadPriority                        priority;
+            uint64_t                                sequence;
+            std::shared_ptr<GameLoadRequest::State> state;
+
+        public:
+            bool operator < (const Item& other) const {
+                if (priority != other.priority)
+                    return priority < other.priority;
+
+                return sequence > other.sequence;
+            }
+        };
+
+        GameVolume&               _volume;
+        std::mutex                _lock;
+        std::condition_variable   _condition;
+        std::priority_queue<Item> _queue;
+        uint64_t                  _sequence;
+        bool                      _stopping;
+        std::vector<std::thread>  _threads;
+
+    public:
+        GameVolumeLoader(GameVolume& volume, size_t threadCount = 2);
+        ~GameVolumeLoader();
+
+        GameVolumeLoader(const GameVolumeLoader&) = delete;
+        GameVolumeLoader& operator = (const GameVolumeLoader&) = delete;
+
+    public:
+        GameLoadRequest enqueue(GameFile file, uint8_t id, GameLoadPriority priority);
+
+        /**
+         * Cancels every load that has not started yet.
+         */
+        void cancelAll();
+
+    private:
+        void run();
+    };
+
+}}
+
+#endif /* __AGIResources__GameVolumeLoader_hpp__ */
@@ -0,0 +1,216 @@
+//
+//  GameVolumeRepacker.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "GameVolumeRepacker.hpp"
+
+#include "Crypt.hpp"
+#include "GameVolume.hpp"
+#include "LZWCompress.hpp"
+#include "PictureExpand.hpp"
+#include "PlatformAbstractionLayer.hpp"
+
+#include <string.h>
+
+using namespace AGI::Resources;
+
+// Offsets are stored on 20 bits, and 0xfffff marks a missing entry.
+static const size_t MaximumVolumeOffset = 0xffffe;
+
+GameVolumeRepacker::GameVolumeRepacker(GameVolume& volume) : _volume(volume), _maximumVolumeSize(MaximumVolumeOffset + 1), _resources(0), _duplicates(0), _bytes(0) {
+}
+
+void GameVolumeRepacker::setMaximumVolumeSize(size_t bytes) {
+    _maximumVolumeSize = std::min(bytes, MaximumVolumeOffset + 1);
+}
+
+std::vector<GameVolumeRepacker::Resource> GameVolumeRepacker::layout() const {
+    static const GameFile types[] = { GameFile::Logic, GameFile::Picture, GameFile::View, GameFile::Sound };
+
+    std::vector<Resource> layout;
+    bool                  placed[4][256];
+
+    memset(placed, 0, sizeof(placed));
+
+    auto place = [this, &layout, &placed](GameFile file, uint8_t id) {
+        size_t type = (size_t)file - (size_t)GameFile::Logic;
+
+        if (type >= 4 || placed[type][id] || !_volume.exists(file, id))
+            return;
+
+        placed[type][id] = true;
+        layout.push_back(Resource(file, id));
+    };
+
+    for (const auto& resource : _order)
+        place(resource.first, resource.second);
+
+    for (int id = 0; id < 256; id++) {
+        for (GameFile file : types)
+            place(file, (uint8_t)id);
+    }
+
+    return layout;
+}
+
+std::vector<uint8_t> GameVolumeRepacker::encode(GameFile file, const std::vector<uint8_t>& data, uint8_t volume) const {
+    if (data.size() > 0xffff)
+        throw std::runtime_error(format("Resource %i is too large to be stored", (int)file));
+
+    std::vector<uint8_t> payload(data);
+    uint8_t              flags = volume;
+
+    if (_volume.info().version() < 0x3000) {
+        if (file == GameFile::Logic)
+            encryptLogic(payload.data(), payload.size(), CRYPT_KEY_SIERRA, CRYPT_KEY_LENGTH);
+
+        std::vector<uint8_t> encoded { 0x12, 0x34, volume, (uint8_t)payload.size(), (uint8_t)(payload.size() >> 8) };
+        encoded.insert(encoded.end(), payload.begin(), payload.end());
+        return encoded;
+    }
+
+    // A compressed length equal to the uncompressed one means stored as is, so an
+    // encoding has to be strictly smaller to be used.
+    std::vector<uint8_t> candidate(LZWCompress(data.data(), data.size()));
+    bool                 raw = true;
+
+    if (candidate.size() < payload.size()) {
+        payload.swap(candidate);
+        raw = false;
+    }
+
+    if (file == GameFile::Picture && PictureCompress(data.data(), data.size(), candidate) && candidate.size() < payload.size()) {
+        payload.swap(candidate);
+        flags |= 0x80;
+        raw = false;
+    }
+
+    // Compressed logics are stored in clear, raw ones have their messages encrypted.
+    if (raw && file == GameFile::Logic)
+        encryptLogic(payload.data(), payload.size(), CRYPT_KEY_SIERRA, CRYPT_KEY_LENGTH);
+
+    std::vector<uint8_t> encoded { 0x12, 0x34, flags, (uint8_t)data.size(), (uint8_t)(data.size() >> 8), (uint8_t)payload.size(), (uint8_t)(payload.size() >> 8) };
+    encoded.insert(encoded.end(), payload.begin(), payload.end());
+    return encoded;
+}
+
+std::string GameVolumeRepacker::volumeFileName(uint8_t volume) const {
+    const GameInfo& info = _volume.info();
+    GameFile        file = (GameFile)((uint8_t)GameFile::Volume_0 + volume);
+
+    if (info.hasFile(file))
+        return info.file(file);
+
+    std::string name(info.file(GameFile::Volume_0));
+    name.back() = '0' + volume;
+    return name;
+}
+
+void GameVolumeRepacker::write(PlatformAbstractionLayer& platform) {
+    std::vector<Resource>                          layout(this->layout());
+    std::vector<std::vector<uint8_t>>              volumes(1);
+    std::vector<uint8_t>                           directories[4];
+    std::unordered_map<std::string, uint32_t>      stored;
+
+    _resources  = 0;
+    _duplicates = 0;
+    _bytes      = 0;
+
+    for (auto& directory : directories)
+        directory.clear();
+
+    for (const auto& resource : layout) {
+        std::vector<uint8_t> data(_volume.load(resource.first, resource.second));
+        uint8_t              volume = (uint8_t)(volumes.size() - 1);
+        std::vector<uint8_t> encoded(encode(resource.first, data, volume));
+
+        // The volume number is part of the header, compare without it.
+        std::string key((const char*)encoded.data() + 3, encoded.size() - 3);
+        key.push_back((char)(encoded[2] & 0x80));
+
+        uint32_t location;
+        auto     it = stored.find(key);
+
+        if (it != stored.end()) {
+            location = it->second;
+            _duplicates++;
+        }
+        else {
+            if (!volumes.back().empty() && (volumes.back().size() + encoded.size()) > _maximumVolumeSize) {
+                if (volumes.size() == 10)
+                    throw std::runtime_error("Too many volumes to repack the game");
+
+                volumes.push_back(std::vector<uint8_t>());
+                volume  = (uint8_t)(volumes.size() - 1);
+                encoded = encode(resource.first, data, volume);
+            }
+
+            if (volumes.back().size() > MaximumVolumeOffset)
+                throw std::runtime_error("Resource does not fit in a volume");
+
+            location = ((uint32_t)volume << 20) | (uint32_t)volumes.back().size();
+            volumes.back().insert(volumes.back().end(), encoded.begin(), encoded.end());
+            stored.emplace(key, location);
+        }
+
+        std::vector<uint8_t>& directory = directories[(size_t)resource.first - (size_t)GameFile::Logic];
+        size_t                index     = (size_t)resource.second * 3;
+
+        if (directory.size() < index + 3)
+            directory.resize(index + 3, 0xff);
+
+        directory[index + 0] = (uint8_t)(location >> 16);
+        directory[index + 1] = (uint8_t)(location >> 8);
+        directory[index + 2] = (uint8_t)location;
+        _resources++;
+    }
+
+    const GameInfo& info = _volume.info();
+
+    auto writeFile = [&platform, this](const std::string& name, const std::vector<uint8_t>& content) {
+        if (!platform.fileWrite(name.c_str(), content.data(), content.size()))
+            throw std::runtime_error(format("Failed to write %s", name.c_str()));
+
+        _bytes += content.size();
+    };
+
+    for (size_t volume = 0; volume < volumes.size(); volume++)
+        writeFile(volumeFileName((uint8_t)volume), volumes[volume]);
+
+    if (info.version() >= 0x3000) {
+        // Logic, picture, view and sound directories, behind a table of their offsets.
+        static const size_t order[] = { 0, 1, 3, 2 };
+        std::vector<uint8_t> content(8, 0);
+
+        for (size_t i = 0; i < 4; i++) {
+            content[i * 2]     = (uint8_t)content.size();
+            content[i * 2 + 1] = (uint8_t)(content.size() >> 8);
+            content.insert(content.end(), directories[order[i]].begin(), directories[order[i]].end());
+        }
+
+        writeFile(info.file(GameFile::Directory), content);
+    }
+    else {
+        static const GameFile files[] = { GameFile::Logic, GameFile::Picture, GameFile::Sound, GameFile::View };
+
+        for (GameFile file : files)
+            writeFile(info.file(file), directories[(size_t)file - (size_t)GameFile::Logic]);
+    }
+
+    static const GameFile copies[] = { GameFile::Objects, GameFile::Words };
+    PlatformAbstractionLayer& source = _volume.platform();
+
+    for (GameFile file : copies) {
+        const std::string&   name = info.file(file);
+        size_t               size = source.fileSize(name.c_str());
+        std::vector<uint8_t> content(size == (size_t)-1 ? 0 : size);
+
+        if (size == (size_t)-1 || !source.fileRead(name.c_str(), 0, content.data(), size))
+            throw std::runtime_error(format("Failed to read %s", name.c_str()));
+
+        writeFile(name, content);
+    }
+}
@@ -0,0 +1,71 @@
+//
+//  GameVolumeRepacker.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__GameVolumeRepacker_hpp__
+#define __AGIResources__GameVolumeRepacker_hpp__
+
+#include "AGIResources.hpp"
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Writes a new set of directory and volume files for a game.
+     *
+     * Resources are laid out in the given access order, the ones that are not listed
+     * follow room by room: logic, picture, view and sound of the same number next to
+     * each other. Identical resources are only stored once, and for version 3 games
+     * every resource is stored in the smallest of its raw, LZW and, for pictures,
+     * nibble packed encodings. Objects and words files are copied unchanged.
+     */
+    class GameVolumeRepacker
+    {
+    public:
+        typedef std::pair<GameFile, uint8_t> Resource;
+
+    private:
+        GameVolume&           _volume;
+        std::vector<Resource> _order;
+        size_t                _maximumVolumeSize;
+
+        size_t                _resources;
+        size_t                _duplicates;
+        size_t                _bytes;
+
+    public:
+        GameVolumeRepacker(GameVolume& volume);
+
+    public:
+        /**
+         * Resources to lay out first, in this order.
+         */
+        inline void setOrder(const std::vector<Resource>& order) { _order = order; }
+
+        /**
+         * Size above which a new volume is started. Cannot exceed what directory
+         * entries can address.
+         */
+        void setMaximumVolumeSize(size_t bytes);
+
+        /**
+         * Writes the files, named like the original ones, through the platform.
+         */
+        void write(PlatformAbstractionLayer& platform);
+
+    public:
+        inline size_t resources() const { return _resources; }
+        inline size_t duplicates() const { return _duplicates; }
+        inline size_t bytes() const { return _bytes; }
+
+    private:
+        std::vector<Resource> layout() const;
+        std::vector<uint8_t> encode(GameFile file, const std::vector<uint8_t>& data, uint8_t volume) const;
+        std::string volumeFileName(uint8_t volume) const;
+    };
+
+}}
+
+#endif /* __AGIResources__GameVolumeRepacker_hpp__ */
@@ -0,0 +1,168 @@
+//
+//  LZWCompress.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "LZWCompress.hpp"
+
+#include <memory>
+#include <string.h>
+
+using namespace AGI::Resources;
+
+LZWCompressor::LZWCompressor() : _generation(1) {
+    memset(_keys, 0, sizeof(_keys));
+    memset(_codes, 0, sizeof(_codes));
+    memset(_generations, 0, sizeof(_generations));
+}
+
+LZWCompressor& LZWCompressor::threadLocal() {
+    static thread_local std::unique_ptr<LZWCompressor> compressor;
+
+    if (!compressor)
+        compressor.reset(new LZWCompressor());
+
+    return *compressor;
+}
+
+void LZWCompressor::clear() {
+    if (++_generation == 0) {
+        memset(_generations, 0, sizeof(_generations));
+        _generation = 1;
+    }
+}
+
+/**
+ * Returns the code of the string, or -1 with slot set to where it can be added.
+ */
+int32_t LZWCompressor::find(uint32_t key, size_t& slot) const {
+    slot = (key * 2654435761u) >> (32 - HASH_BITS);
+
+    for (;;) {
+        if (_generations[slot] != _generation)
+            return -1;
+
+        if (_keys[slot] == key)
+            return _codes[slot];
+
+        slot = (slot + 1) & (HASH_SIZE - 1);
+    }
+}
+
+namespace {
+
+    class LZWBitWriter {
+    private:
+        std::vector<uint8_t>& _output;
+        uint64_t              _bits;
+        uint32_t              _count;
+
+    public:
+        inline LZWBitWriter(std::vector<uint8_t>& output) : _output(output), _bits(0), _count(0) {
+        }
+
+        inline void write(uint32_t code, uint32_t width) {
+            _bits  |= (uint64_t)code << _count;
+            _count += width;
+
+            while (_count >= 8) {
+                _output.push_back((uint8_t)_bits);
+                _bits  >>= 8;
+                _count -= 8;
+            }
+        }
+
+        inline void flush() {
+            if (_count)
+                _output.push_back((uint8_t)_bits);
+
+            _bits  = 0;
+            _count = 0;
+        }
+    };
+
+}
+
+std::vector<uint8_t> LZWCompressor::compress(Span<const uint8_t> input) {
+    std::vector<uint8_t> output;
+    LZWBitWriter         writer(output);
+
+    // State of the decoder, mirrored to know the width it reads every code with.
+    int32_t bits        = START_BITS;
+    int32_t next        = 257;
+    bool    afterClear  = false;
+
+    auto emit = [&](uint32_t code) {
+        writer.write(code, bits);
+
+        if (afterClear) {
+            // The literal following a clear defines nothing.
+            afterClear = false;
+            return;
+        }
+
+        if (next > (1 << bits) - 2 && bits + 1 != MAXBITS)
+            bits++;
+
+        next++;
+    };
+
+    output.reserve(input.size() / 2 + 16);
+
+    // The decoder discards the first code.
+    writer.write(0x100, bits);
+
+    if (input.empty()) {
+        writer.write(0x101, bits);
+        writer.flush();
+        return output;
+    }
+
+    clear();
+
+    uint32_t w         = input[0];
+    uint32_t available = 258;
+
+    for (size_t i = 1; i < input.size(); i++) {
+        uint8_t  c   = input[i];
+        uint32_t key = (w << 8) | c;
+        size_t   slot;
+        int32_t  code = find(key, slot);
+
+        if (code >= 0) {
+            w = code;
+            continue;
+        }
+
+        emit(w);
+
+        if (available < CODES) {
+            _keys[slot]        = key;
+            _codes[slot]       = available++;
+            _generations[slot] = _generation;
+        }
+        else {
+            // Every 11 bits code is taken, start over.
+            writer.write(0x100, bits);
+            clear();
+
+            bits       = START_BITS;
+            next       = 258;
+            available  = 258;
+            afterClear = true;
+        }
+
+        w = c;
+    }
+
+    emit(w);
+    writer.write(0x101, bits);
+    writer.flush();
+    return output;
+}
+
+std::vector<uint8_t> AGI::Resources::LZWCompress(const uint8_t* input, size_t inputSize) {
+    return LZWCompressor::threadLocal().compress(Span<const uint8_t>(input, inputSize));
+}
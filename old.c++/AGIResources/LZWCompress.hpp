@@ -0,0 +1,65 @@
+//
+//  LZWCompress.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__LZWCompress_hpp__
+#define __AGIResources__LZWCompress_hpp__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "Span.hpp"
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Encoder for the LZW variant of version 3 games, the counterpart of
+     * LZWExpander. Codes are written with the width the decoder will be using
+     * when it reads them, and the dictionary is started over with code 256 once
+     * every 11 bits code is taken. Strings are looked up in an open addressing
+     * hash of (prefix code, character) pairs, which is invalidated in constant time
+     * by bumping a generation number.
+     */
+    class LZWCompressor {
+    private:
+        enum {
+            START_BITS  = 9,
+            MAXBITS     = 12,
+            CODES       = 1 << (MAXBITS - 1),
+            HASH_BITS   = 13,
+            HASH_SIZE   = 1 << HASH_BITS,
+        };
+
+        uint32_t _keys[HASH_SIZE];
+        uint16_t _codes[HASH_SIZE];
+        uint16_t _generations[HASH_SIZE];
+        uint16_t _generation;
+
+    public:
+        LZWCompressor();
+
+        LZWCompressor(const LZWCompressor&) = delete;
+        LZWCompressor& operator = (const LZWCompressor&) = delete;
+
+        std::vector<uint8_t> compress(Span<const uint8_t> input);
+
+        /**
+         * The calling thread's compressor, allocated on first use.
+         */
+        static LZWCompressor& threadLocal();
+
+    private:
+        void clear();
+        int32_t find(uint32_t key, size_t& slot) const;
+    };
+
+    std::vector<uint8_t> LZWCompress(const uint8_t* input, size_t inputSize);
+
+}}
+
+#endif /* __AGIResources__LZWCompress_hpp__ */
@@ -7,45 +7,39 @@
 
 #include "LZWExpand.hpp"
 
+#include "Endian.hpp"
+
+#include <algorithm>
 #include <exception>
 #include <memory>
+#include <stdexcept>
+#include <string.h>
 
 using namespace AGI::Resources;
 
-namespace AGI { namespace Resources {
-
-    class LZWExpander {
-    private:
-        enum {
-            MAXBITS     = 12,
-            TABLE_SIZE  = 18041,    // strange number
-            START_BITS  = 9
-        };
-
-        int32_t BITS, MAX_VALUE, MAX_CODE;
-        uint32_t prefixCode[TABLE_SIZE];
-        uint8_t appendCharacter[TABLE_SIZE];
-        uint8_t decodeStack[8192];
-        int32_t inputBitCount;    // Number of bits in input bit buffer
-        uint32_t inputBitBuffer;
+LZWExpander::LZWExpander(): BITS(0), MAX_VALUE(0), MAX_CODE(0), inputBitCount(0), inputBitBuffer(0), inputEnd(nullptr) {
+    memset(decodeStack, 0, sizeof(decodeStack));
+    memset(appendCharacter, 0, sizeof(appendCharacter));
+    memset(prefixCode, 0, sizeof(prefixCode));
+}
 
-    public:
-        LZWExpander();
+LZWExpander& LZWExpander::threadLocal() {
+    static thread_local std::unique_ptr<LZWExpander> expander;
 
-        bool expand(const uint8_t* in, uint8_t* out, size_t len);
+    if (!expander)
+        expander.reset(new LZWExpander());
 
-    private:
-        bool setBits(int32_t value);
-        uint8_t *decodeString(uint8_t *buffer, uint32_t code);
-        uint32_t inputCode(const uint8_t** input);
-    };
-
-}}
+    return *expander;
+}
 
-LZWExpander::LZWExpander(): inputBitCount(0), inputBitBuffer(0), BITS(0), MAX_VALUE(0), MAX_CODE(0) {
-    memset(decodeStack, 0, sizeof(decodeStack));
-    memset(appendCharacter, 0, sizeof(appendCharacter));
-    memset(prefixCode, 0, sizeof(prefixCode));
+/**
+ * Only the bit reader carries state from one resource to the next. The tables
+ * are not cleared: codes that are not defined yet are rejected by expand(), so
+ * every entry is written before it is read.
+ */
+void LZWExpander::reset() {
+    inputBitCount  = 0;
+    inputBitBuffer = 0;
 }
 
 /**
@@ -87,7 +81,9 @@ uint32_t LZWExpander::inputCode(const uint8_t** input) {
     uint32_t r;
 
     while (inputBitCount <= 24) {
-        inputBitBuffer |= (uint32_t) * (*input)++ << inputBitCount;
+        if (*input < inputEnd)
+            inputBitBuffer |= (uint32_t) * (*input)++ << inputBitCount;
+
         inputBitCount += 8;
     }
 
@@ -107,16 +103,19 @@ uint32_t LZWExpander::inputCode(const uint8_t** input) {
  *  code 256 = start over
  *  code 257 = end of data
  */
-bool LZWExpander::expand(const uint8_t *in, uint8_t *out, size_t len) {
+bool LZWExpander::expand(Span<const uint8_t> input, Span<uint8_t> output) {
     int32_t c, lzwnext, lzwnew, lzwold;
     uint8_t* s;
-    uint8_t* end;
+    uint8_t* out = output.begin();
+    uint8_t* end = output.end();
+    const uint8_t* in = input.begin();
+
+    reset();
+    inputEnd = input.end();
 
     setBits(START_BITS); // Starts at 9-bits
     lzwnext = 257;       // Next available code to define
 
-    end = out + len;
-
     lzwold = c = inputCode(&in); // Read in the first code
     lzwnew = inputCode(&in);
 
@@ -126,12 +125,18 @@ bool LZWExpander::expand(const uint8_t *in, uint8_t *out, size_t len) {
             lzwnext = 258;
             setBits(START_BITS);
             lzwold = inputCode(&in);
+            if (lzwold > 0xff)
+                throw std::runtime_error("lzw: undefined code");
+
             c = lzwold;
             *out++ = (char)c;
             lzwnew = inputCode(&in);
         }
         else {
-            if (lzwnew >= lzwnext) {
+            if (lzwnew > lzwnext)
+                throw std::runtime_error("lzw: undefined code");
+
+            if (lzwnew == lzwnext) {
                 // Handles special LZW scenario
                 *decodeStack = c;
                 s = decodeString(decodeStack + 1, lzwold);
@@ -142,12 +147,15 @@ bool LZWExpander::expand(const uint8_t *in, uint8_t *out, size_t len) {
 
             // Reverse order of decoded string and store in out buffer
             c = *s;
-            while (s >= decodeStack)
+            while (s >= decodeStack && out < end)
                 *out++ = *s--;
 
             if (lzwnext > MAX_CODE)
                 setBits(BITS + 1);
 
+            if (lzwnext >= TABLE_SIZE)
+                throw std::runtime_error("lzw: code table overflow");
+
             prefixCode[lzwnext] = lzwold;
             appendCharacter[lzwnext] = c;
             lzwnext++;
@@ -160,7 +168,338 @@ bool LZWExpander::expand(const uint8_t *in, uint8_t *out, size_t len) {
     return out == end;
 }
 
+LZWDecoder::LZWDecoder() {
+    memset(strings, 0, sizeof(strings));
+}
+
+LZWDecoder& LZWDecoder::threadLocal() {
+    static thread_local std::unique_ptr<LZWDecoder> decoder;
+
+    if (!decoder)
+        decoder.reset(new LZWDecoder());
+
+    return *decoder;
+}
+
+namespace {
+
+    /**
+     * Little endian bit reader over a bounded input, reading zeros past its end
+     * like LZWExpander does.
+     */
+    class LZWBitReader {
+    private:
+        const uint8_t* _input;
+        const uint8_t* _end;
+        uint64_t       _bits;
+        uint32_t       _count;
+
+    public:
+        inline LZWBitReader(const uint8_t* input, const uint8_t* end) : _input(input), _end(end), _bits(0), _count(0) {
+        }
+
+        inline uint32_t read(uint32_t width) {
+            if (_count < width)
+                refill();
+
+            uint32_t code = (uint32_t)_bits & ((1u << width) - 1);
+            _bits >>= width;
+            _count -= width;
+            return code;
+        }
+
+    private:
+        inline void refill() {
+            if ((_end - _input) >= 8) {
+                _bits |= readUINT64LE(_input) << _count;
+                _input += (63 - _count) >> 3;
+                _count |= 56;
+                return;
+            }
+
+            while (_count <= 56) {
+                if (_input < _end)
+                    _bits |= (uint64_t)*_input++ << _count;
+
+                _count += 8;
+            }
+        }
+    };
+
+    /**
+     * Copies a string that lies entirely before the destination, a word at a time.
+     * The last word is aligned on the end of the string so that nothing past it is
+     * ever written.
+     */
+    inline void copyForward(uint8_t* out, const uint8_t* source, size_t length) {
+        if (length >= 8) {
+            uint64_t word;
+            size_t   i = 0;
+
+            for (; i + 8 <= length; i += 8) {
+                memcpy(&word, source + i, 8);
+                memcpy(out + i, &word, 8);
+            }
+
+            if (i < length) {
+                memcpy(&word, source + length - 8, 8);
+                memcpy(out + length - 8, &word, 8);
+            }
+        }
+        else if (length >= 4) {
+            uint32_t head, tail;
+
+            memcpy(&head, source, 4);
+            memcpy(&tail, source + length - 4, 4);
+            memcpy(out, &head, 4);
+            memcpy(out + length - 4, &tail, 4);
+        }
+        else {
+            for (size_t i = 0; i < length; i++)
+                out[i] = source[i];
+        }
+    }
+
+}
+
+bool LZWDecoder::expand(Span<const uint8_t> input, Span<uint8_t> output) {
+    uint8_t* const begin = output.begin();
+    uint8_t* const end   = output.end();
+    uint8_t*       out   = begin;
+    LZWBitReader   reader(input.begin(), input.end());
+    uint32_t       bits  = START_BITS;
+    uint32_t       next  = 257;
+
+    // Output range of the previously decoded string, or none at the very start,
+    // where the reference decoder discards the first code.
+    uint8_t* previous       = nullptr;
+    uint32_t previousLength = 0;
+
+    reader.read(bits);
+    uint32_t code = reader.read(bits);
+
+    while (out < end && code != 0x101) {
+        if (code == 0x100) {
+            next = 258;
+            bits = START_BITS;
+
+            code = reader.read(bits);
+            if (code > 0xff)
+                throw std::runtime_error("lzw: undefined code");
+
+            previous       = out;
+            previousLength = 1;
+            *out++ = (uint8_t)code;
+
+            code = reader.read(bits);
+            continue;
+        }
+
+        uint8_t* current = out;
+        uint32_t length;
+
+        if (code >= next) {
+            // The code being defined right now: previous string plus its own first
+            // byte. Codes past it are not defined yet, the stream is corrupted. At
+            // the very start, next is 257 and this can only be such a code.
+            if (!previous || code > next)
+                throw std::runtime_error("lzw: undefined code");
+
+            length = previousLength + 1;
+            copyForward(out, previous, std::min((size_t)previousLength, (size_t)(end - out)));
+
+            if ((size_t)(end - out) > previousLength)
+                out[previousLength] = *previous;
+        }
+        else if (code < 256) {
+            length = 1;
+            *out = (uint8_t)code;
+        }
+        else {
+            const String& string = strings[code];
+
+            length = string.length;
+            copyForward(out, begin + string.offset, std::min((size_t)length, (size_t)(end - out)));
+        }
+
+        out += std::min((size_t)length, (size_t)(end - out));
+
+        if (next > (1u << bits) - 2 && bits + 1 != MAXBITS)
+            bits++;
+
+        if (next >= TABLE_SIZE)
+            throw std::runtime_error("lzw: code table overflow");
+
+        if (next < CODES && previous) {
+            strings[next].offset = (uint32_t)(previous - begin);
+            strings[next].length = previousLength + 1;
+        }
+
+        next++;
+        previous       = current;
+        previousLength = length;
+
+        code = reader.read(bits);
+    }
+
+    return out == end;
+}
+
+LZWStreamExpander::LZWStreamExpander() {
+    memset(decodeStack, 0, sizeof(decodeStack));
+    memset(appendCharacter, 0, sizeof(appendCharacter));
+    memset(prefixCode, 0, sizeof(prefixCode));
+    reset(0);
+}
+
+LZWStreamExpander& LZWStreamExpander::threadLocal() {
+    static thread_local std::unique_ptr<LZWStreamExpander> expander;
+
+    if (!expander)
+        expander.reset(new LZWStreamExpander());
+
+    return *expander;
+}
+
+void LZWStreamExpander::reset(size_t outputLength) {
+    _state     = First;
+    _bits      = START_BITS;
+    _next      = 257;
+    _old       = 0;
+    _c         = 0;
+    _bitBuffer = 0;
+    _bitCount  = 0;
+    _pending   = 0;
+    _remaining = outputLength;
+}
+
+uint8_t* LZWStreamExpander::decodeString(uint8_t* buffer, uint32_t code) {
+    uint32_t i;
+
+    for (i = 0; code > 255;) {
+        *buffer++ = appendCharacter[code];
+        code = prefixCode[code];
+        if (i++ >= 4000)
+            throw std::runtime_error("lzw: error in code expansion");
+    }
+
+    *buffer = code;
+    return buffer;
+}
+
+bool LZWStreamExpander::readCode(Span<const uint8_t>& input, bool last, uint32_t& code) {
+    while (_bitCount < (uint32_t)_bits) {
+        if (!input.empty()) {
+            _bitBuffer |= (uint64_t)input[0] << _bitCount;
+            input = input.subspan(1, input.size() - 1);
+        }
+        else if (!last) {
+            return false;
+        }
+
+        _bitCount += 8;
+    }
+
+    code = (uint32_t)_bitBuffer & ((1u << _bits) - 1);
+    _bitBuffer >>= _bits;
+    _bitCount -= _bits;
+    return true;
+}
+
+/**
+ * Same state machine as LZWExpander::expand(), unrolled so that it can stop
+ * whenever a code is not fully available yet or the output is full.
+ */
+bool LZWStreamExpander::expand(Span<const uint8_t>& input, Span<uint8_t>& output, bool last) {
+    for (;;) {
+        size_t count = std::min(std::min(_pending, output.size()), _remaining);
+
+        for (size_t i = 0; i < count; i++)
+            output[i] = decodeStack[_pending - 1 - i];
+
+        _pending   -= count;
+        _remaining -= count;
+        output      = output.subspan(count, output.size() - count);
+
+        if (_remaining == 0)
+            _state = Done;
+
+        if (_state == Done)
+            return true;
+
+        if (_pending)
+            return false;
+
+        uint32_t code;
+        if (!readCode(input, last, code))
+            return false;
+
+        switch (_state) {
+        case First:
+            _old   = _c = code;
+            _state = Code;
+            break;
+
+        case ClearLiteral:
+            if (code > 0xff)
+                throw std::runtime_error("lzw: undefined code");
+
+            _old           = _c = code;
+            decodeStack[0] = (uint8_t)_c;
+            _pending       = 1;
+            _state         = Code;
+            break;
+
+        case Code: {
+            if (code == 0x101) {
+                _state = Done;
+                break;
+            }
+
+            if (code == 0x100) {
+                // Code to "start over"
+                _next  = 258;
+                _bits  = START_BITS;
+                _state = ClearLiteral;
+                break;
+            }
+
+            uint8_t* s;
+
+            if ((int32_t)code > _next)
+                throw std::runtime_error("lzw: undefined code");
+
+            if ((int32_t)code == _next) {
+                // Handles special LZW scenario
+                *decodeStack = _c;
+                s = decodeString(decodeStack + 1, _old);
+            }
+            else {
+                s = decodeString(decodeStack, code);
+            }
+
+            _c       = *s;
+            _pending = s - decodeStack + 1;
+
+            if (_next > (1 << _bits) - 2 && _bits + 1 != MAXBITS)
+                _bits++;
+
+            if (_next >= TABLE_SIZE)
+                throw std::runtime_error("lzw: code table overflow");
+
+            prefixCode[_next]      = _old;
+            appendCharacter[_next] = _c;
+            _next++;
+            _old = code;
+            break;
+        }
+
+        case Done:
+            break;
+        }
+    }
+}
+
 bool AGI::Resources::LZWExpand(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize) {
-    std::unique_ptr<LZWExpander> expander(new LZWExpander());
-    return expander->expand(input, output, outputSize);
+    return LZWDecoder::threadLocal().expand(Span<const uint8_t>(input, inputSize), Span<uint8_t>(output, outputSize));
 }
@@ -11,8 +11,166 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "Span.hpp"
+
 namespace AGI { namespace Resources {
 
+    /**
+     * Decoder for the LZW variant used by version 3 games. Its tables are large,
+     * so an expander is meant to be kept around and reused: nothing is cleared
+     * between two resources besides the bit reader and the code width. An expander
+     * must not be used by two threads at once, see threadLocal().
+     */
+    class LZWExpander {
+    private:
+        enum {
+            MAXBITS     = 12,
+            TABLE_SIZE  = 18041,    // strange number
+            START_BITS  = 9
+        };
+
+        int32_t BITS, MAX_VALUE, MAX_CODE;
+        uint32_t prefixCode[TABLE_SIZE];
+        uint8_t appendCharacter[TABLE_SIZE];
+        uint8_t decodeStack[8192];
+        int32_t inputBitCount;    // Number of bits in input bit buffer
+        uint32_t inputBitBuffer;
+        const uint8_t* inputEnd;
+
+    public:
+        LZWExpander();
+
+        LZWExpander(const LZWExpander&) = delete;
+        LZWExpander& operator = (const LZWExpander&) = delete;
+
+        /**
+         * Expands input into output, never reading or writing outside of either.
+         * Returns true when the whole output was filled. Throws on codes that are
+         * not defined yet, which only corrupted data has.
+         */
+        bool expand(Span<const uint8_t> input, Span<uint8_t> output);
+
+        /**
+         * The calling thread's expander, allocated on first use.
+         */
+        static LZWExpander& threadLocal();
+
+    private:
+        void reset();
+        bool setBits(int32_t value);
+        uint8_t *decodeString(uint8_t *buffer, uint32_t code);
+        uint32_t inputCode(const uint8_t** input);
+    };
+
+    /**
+     * Faster decoder for the same LZW variant, producing the exact same output as
+     * LZWExpander. Instead of a prefix chain, every dictionary string is kept as
+     * an offset and a length into the output already written, and is copied
+     * forward in one go. Codes are pulled out of a 64 bits bit reservoir refilled
+     * eight bytes at a time.
+     */
+    class LZWDecoder {
+    private:
+        enum {
+            MAXBITS     = 12,
+            TABLE_SIZE  = 18041,
+            START_BITS  = 9,
+            CODES       = 1 << (MAXBITS - 1),
+        };
+
+        class String {
+        public:
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        String strings[CODES];
+
+    public:
+        LZWDecoder();
+
+        LZWDecoder(const LZWDecoder&) = delete;
+        LZWDecoder& operator = (const LZWDecoder&) = delete;
+
+        /**
+         * Same contract as LZWExpander::expand().
+         */
+        bool expand(Span<const uint8_t> input, Span<uint8_t> output);
+
+        /**
+         * The calling thread's decoder, allocated on first use.
+         */
+        static LZWDecoder& threadLocal();
+    };
+
+    /**
+     * Resumable version of LZWExpander: the compressed input can be handed over in
+     * chunks of any size as it arrives, and the output is produced incrementally
+     * into buffers of any size. Every bit of state lives in the object, so nothing
+     * needs to be kept around between two calls besides the expander itself.
+     */
+    class LZWStreamExpander {
+    private:
+        enum {
+            MAXBITS     = 12,
+            TABLE_SIZE  = 18041,
+            START_BITS  = 9
+        };
+
+        enum State {
+            First,
+            Code,
+            ClearLiteral,
+            Done,
+        };
+
+        uint32_t prefixCode[TABLE_SIZE];
+        uint8_t  appendCharacter[TABLE_SIZE];
+        uint8_t  decodeStack[8192];
+
+        State    _state;
+        int32_t  _bits;
+        int32_t  _next;
+        int32_t  _old;
+        int32_t  _c;
+        uint64_t _bitBuffer;
+        uint32_t _bitCount;
+        size_t   _pending;      // Bytes of decodeStack still to be written out
+        size_t   _remaining;    // Bytes of output still expected
+
+    public:
+        LZWStreamExpander();
+
+        LZWStreamExpander(const LZWStreamExpander&) = delete;
+        LZWStreamExpander& operator = (const LZWStreamExpander&) = delete;
+
+        /**
+         * Starts a new stream that decodes to outputLength bytes.
+         */
+        void reset(size_t outputLength);
+
+        /**
+         * Consumes input and fills output, advancing both spans past what was used.
+         * It stops when output is full or when input runs out; pass last once the
+         * final chunk of input has been given, the stream is then padded with zeros
+         * like LZWExpander does. Returns true once the stream is finished. Throws
+         * on codes that are not defined yet, like LZWExpander.
+         */
+        bool expand(Span<const uint8_t>& input, Span<uint8_t>& output, bool last);
+
+        inline bool finished() const { return _state == Done; }
+        inline bool complete() const { return _remaining == 0; }
+
+        /**
+         * The calling thread's expander, allocated on first use.
+         */
+        static LZWStreamExpander& threadLocal();
+
+    private:
+        bool readCode(Span<const uint8_t>& input, bool last, uint32_t& code);
+        uint8_t *decodeString(uint8_t *buffer, uint32_t code);
+    };
+
     bool LZWExpand(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize);
 
 }}
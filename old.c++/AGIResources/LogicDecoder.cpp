@@ -9,6 +9,8 @@
 
 #include "Endian.hpp"
 
+#include <string.h>
+
 using namespace AGI::Resources;
 
 LogicInstruction::LogicInstruction() :
@@ -29,29 +31,45 @@ LogicInstructionBuffer::LogicInstructionBuffer() :
     _instructionEnd    (nullptr) {
 }
 
-LogicDecoder::LogicDecoder(std::vector<uint8_t>&& buffer) : _buffer(std::move(buffer)) {
+LogicDecoder::LogicDecoder(std::vector<uint8_t>&& buffer) : _buffer(std::move(buffer)), _data(_buffer.data(), _buffer.size()) {
+}
+
+LogicDecoder::LogicDecoder(const std::vector<uint8_t>& buffer) : _buffer(buffer), _data(_buffer.data(), _buffer.size()) {
 }
 
-LogicDecoder::LogicDecoder(const std::vector<uint8_t>& buffer) : _buffer(buffer) {
+LogicDecoder::LogicDecoder(Span<const uint8_t> data) : _data(data) {
 }
 
 void LogicDecoder::decode(const LogicInstructionSet& instructionSet, LogicCallback& callback) {
-    uint8_t* data   = _buffer.data();
-    uint8_t* m0     = data;
-    uint16_t mstart = readUINT16LE(m0) + 2;
-    uint8_t  mc     = m0[mstart];
-    uint16_t mend   = readUINT16LE(m0 + mstart + 1);
+    const uint8_t* data   = _data.data();
+    const uint8_t* end    = data + _data.size();
+    const uint8_t* m0     = data;
+    uint16_t       mstart = readUINT16LE(m0) + 2;
+    uint8_t        mc     = m0[mstart];
+    uint16_t       mend   = readUINT16LE(m0 + mstart + 1);
+    std::string    message;
 
     m0 += mstart + 3;
 
+    // The same string is reused for every message, it only allocates when a
+    // message is longer than all the previous ones. Messages stop at the end of
+    // the data even when the last one is not terminated.
     for (size_t i = 0; i < mc; i++) {
         mend = readUINT16LE(m0 + i * 2);
-        callback.message(i, mend ? std::string((const char*)m0 + mend - 2) : std::string());
+
+        const uint8_t* text = m0 + mend - 2;
+
+        if (mend && text < end)
+            message.assign((const char*)text, strnlen((const char*)text, end - text));
+        else
+            message.clear();
+
+        callback.message(i, message);
     }
 
-    uint8_t* istart = data + 2;
-    uint8_t* ip     = istart;
-    uint8_t* iend   = data + mstart;
+    const uint8_t* istart = data + 2;
+    const uint8_t* ip     = istart;
+    const uint8_t* iend   = data + mstart;
 
     bool isInCondition = false;
     LogicInstructionBuffer ibuffer;
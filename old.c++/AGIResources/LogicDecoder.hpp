@@ -9,6 +9,7 @@
 #define __AGIResources__LogicDecoder_hpp__
 
 #include "LogicInstructionSet.hpp"
+#include "Span.hpp"
 
 namespace AGI { namespace Resources {
 
@@ -83,11 +84,22 @@ namespace AGI { namespace Resources {
     class LogicDecoder {
     private:
         std::vector<uint8_t> _buffer;
+        Span<const uint8_t>  _data;
 
     public:
         LogicDecoder(std::vector<uint8_t>&& buffer);
         LogicDecoder(const std::vector<uint8_t>& buffer);
 
+        /**
+         * Decodes data owned by the caller, such as a buffer living in an arena,
+         * without copying it. The data must outlive the decoder.
+         */
+        LogicDecoder(Span<const uint8_t> data);
+
+        // The decoder may point into its own buffer, it cannot be copied.
+        LogicDecoder(const LogicDecoder&) = delete;
+        LogicDecoder& operator = (const LogicDecoder&) = delete;
+
     public:
         void decode(const LogicInstructionSet& instructionSet, LogicCallback& callback);
 
@@ -7,6 +7,9 @@
 
 #include "LogicInstructionSet.hpp"
 
+#include <assert.h>
+#include <stdarg.h>
+
 using namespace AGI::Resources;
 
 LogicOperand::LogicOperand(Type type, uint8_t data) : _type(type), _data(data) {
@@ -0,0 +1,160 @@
+//
+//  MD5.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "MD5.hpp"
+
+#include <string.h>
+
+using namespace AGI::Resources;
+
+MD5::MD5() : _length(0), _blockUsed(0) {
+    _state[0] = 0x67452301;
+    _state[1] = 0xefcdab89;
+    _state[2] = 0x98badcfe;
+    _state[3] = 0x10325476;
+}
+
+static inline uint32_t rotateLeft(uint32_t value, int count) {
+    return (value << count) | (value >> (32 - count));
+}
+
+static inline uint32_t readUINT32LE(const uint8_t* data) {
+    return ((uint32_t)data[0]) | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+void MD5::transform(const uint8_t* block) {
+    static const uint32_t K[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
+
+    static const int S[64] = {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+    };
+
+    uint32_t M[16];
+
+    for (int i = 0; i < 16; i++)
+        M[i] = readUINT32LE(block + (i * 4));
+
+    uint32_t a = _state[0];
+    uint32_t b = _state[1];
+    uint32_t c = _state[2];
+    uint32_t d = _state[3];
+
+    for (int i = 0; i < 64; i++) {
+        uint32_t f;
+        int      g;
+
+        if (i < 16) {
+            f = (b & c) | (~b & d);
+            g = i;
+        }
+        else if (i < 32) {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) & 15;
+        }
+        else if (i < 48) {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) & 15;
+        }
+        else {
+            f = c ^ (b | ~d);
+            g = (7 * i) & 15;
+        }
+
+        uint32_t temp = d;
+        d = c;
+        c = b;
+        b = b + rotateLeft(a + f + K[i] + M[g], S[i]);
+        a = temp;
+    }
+
+    _state[0] += a;
+    _state[1] += b;
+    _state[2] += c;
+    _state[3] += d;
+}
+
+void MD5::update(const void* data, size_t length) {
+    const uint8_t* input = (const uint8_t*)data;
+
+    _length += length;
+
+    if (_blockUsed) {
+        size_t count = BlockLength - _blockUsed;
+        if (count > length)
+            count = length;
+
+        memcpy(_block + _blockUsed, input, count);
+        _blockUsed += count;
+        input      += count;
+        length     -= count;
+
+        if (_blockUsed < BlockLength)
+            return;
+
+        transform(_block);
+        _blockUsed = 0;
+    }
+
+    for (; length >= BlockLength; input += BlockLength, length -= BlockLength)
+        transform(input);
+
+    if (length) {
+        memcpy(_block, input, length);
+        _blockUsed = length;
+    }
+}
+
+void MD5::final(uint8_t digest[DigestLength]) {
+    static const uint8_t padding[BlockLength] = { 0x80 };
+
+    uint64_t bitLength = _length << 3;
+    uint8_t  lengthBytes[8];
+
+    for (int i = 0; i < 8; i++)
+        lengthBytes[i] = (uint8_t)(bitLength >> (i * 8));
+
+    size_t padLength = (_blockUsed < 56) ? (56 - _blockUsed) : (120 - _blockUsed);
+
+    update(padding, padLength);
+    update(lengthBytes, sizeof(lengthBytes));
+
+    for (int i = 0; i < 4; i++) {
+        digest[(i * 4) + 0] = (uint8_t)(_state[i]);
+        digest[(i * 4) + 1] = (uint8_t)(_state[i] >> 8);
+        digest[(i * 4) + 2] = (uint8_t)(_state[i] >> 16);
+        digest[(i * 4) + 3] = (uint8_t)(_state[i] >> 24);
+    }
+}
+
+std::string MD5::finalString() {
+    static const char hex[] = "0123456789abcdef";
+
+    uint8_t digest[DigestLength];
+    char    digestString[(DigestLength * 2) + 1];
+
+    final(digest);
+
+    for (int i = 0; i < DigestLength; i++) {
+        digestString[(i * 2) + 0] = hex[digest[i] >> 4];
+        digestString[(i * 2) + 1] = hex[digest[i] & 0xf];
+    }
+
+    digestString[DigestLength * 2] = 0;
+    return digestString;
+}
@@ -0,0 +1,49 @@
+//
+//  MD5.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__MD5_hpp__
+#define __AGIResources__MD5_hpp__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <string>
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Self contained, streaming MD5 (RFC 1321). Data can be fed in chunks of any
+     * size, only a single 64 bytes block is ever buffered.
+     */
+    class MD5 {
+    public:
+        enum {
+            DigestLength = 16,
+            BlockLength  = 64
+        };
+
+    private:
+        uint32_t _state[4];
+        uint64_t _length;
+        uint8_t  _block[BlockLength];
+        size_t   _blockUsed;
+
+    public:
+        MD5();
+
+    public:
+        void update(const void* data, size_t length);
+        void final(uint8_t digest[DigestLength]);
+        std::string finalString();
+
+    private:
+        void transform(const uint8_t* block);
+    };
+
+}}
+
+#endif /* __AGIResources__MD5_hpp__ */
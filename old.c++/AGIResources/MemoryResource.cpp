@@ -0,0 +1,99 @@
+//
+//  MemoryResource.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "MemoryResource.hpp"
+
+#include <algorithm>
+#include <assert.h>
+
+using namespace AGI::Resources;
+
+namespace {
+
+    class NewDeleteResource : public MemoryResource {
+    public:
+        virtual void* allocate(size_t bytes, size_t alignment) override {
+            assert(alignment <= alignof(std::max_align_t));
+            (void)alignment;
+            return ::operator new(bytes);
+        }
+
+        virtual void deallocate(void* pointer, size_t /* bytes */, size_t /* alignment */) override {
+            ::operator delete(pointer);
+        }
+    };
+
+}
+
+MemoryResource* AGI::Resources::newDeleteResource() {
+    static NewDeleteResource resource;
+    return &resource;
+}
+
+MonotonicBufferResource::MonotonicBufferResource(size_t initialChunkSize, MemoryResource* upstream) :
+    _upstream        (upstream),
+    _chunks          (nullptr),
+    _current         (nullptr),
+    _available       (0),
+    _nextChunkSize   (initialChunkSize),
+    _initialChunkSize(initialChunkSize) {
+}
+
+MonotonicBufferResource::~MonotonicBufferResource() {
+    release();
+}
+
+void* MonotonicBufferResource::allocate(size_t bytes, size_t alignment) {
+    assert(alignment && (alignment & (alignment - 1)) == 0 && alignment <= alignof(std::max_align_t));
+
+    size_t padding = (alignment - ((uintptr_t)_current & (alignment - 1))) & (alignment - 1);
+
+    if (!_current || padding + bytes > _available) {
+        grow(bytes);
+        padding = 0;
+    }
+
+    uint8_t* pointer = _current + padding;
+
+    _current   += padding + bytes;
+    _available -= padding + bytes;
+    return pointer;
+}
+
+void MonotonicBufferResource::deallocate(void* /* pointer */, size_t /* bytes */, size_t /* alignment */) {
+}
+
+void MonotonicBufferResource::release() {
+    while (_chunks) {
+        Chunk* next = _chunks->next;
+
+        _upstream->deallocate(_chunks, _chunks->size);
+        _chunks = next;
+    }
+
+    _current       = nullptr;
+    _available     = 0;
+    _nextChunkSize = _initialChunkSize;
+}
+
+/**
+ * Chunks start with their header, padded so that the memory following it is
+ * maximally aligned. Each chunk is twice as large as the previous one.
+ */
+void MonotonicBufferResource::grow(size_t minimum) {
+    const size_t headerSize = (sizeof(Chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    size_t       size       = std::max(_nextChunkSize, minimum + headerSize);
+    Chunk*       chunk      = static_cast<Chunk*>(_upstream->allocate(size));
+
+    chunk->next = _chunks;
+    chunk->size = size;
+    _chunks     = chunk;
+
+    _current       = reinterpret_cast<uint8_t*>(chunk) + headerSize;
+    _available     = size - headerSize;
+    _nextChunkSize = size * 2;
+}
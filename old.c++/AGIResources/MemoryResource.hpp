@@ -0,0 +1,124 @@
+//
+//  MemoryResource.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__MemoryResource_hpp__
+#define __AGIResources__MemoryResource_hpp__
+
+#include "AGIResources.hpp"
+
+#include <cstddef>
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Source of raw memory that containers can be bound to through a
+     * MemoryAllocator, in the spirit of std::pmr::memory_resource.
+     */
+    class MemoryResource {
+    public:
+        virtual ~MemoryResource() {}
+
+    public:
+        virtual void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) = 0;
+        virtual void  deallocate(void* pointer, size_t bytes, size_t alignment = alignof(std::max_align_t)) = 0;
+    };
+
+    /**
+     * Memory resource forwarding to the global operator new and operator delete.
+     */
+    MemoryResource* newDeleteResource();
+
+    /**
+     * Arena handing out memory from chunks that only grow, every deallocation is a
+     * no-op. Everything is freed at once by release() or by the destructor, which
+     * makes it suited for decoding a whole game and dropping the result in one shot.
+     * Not thread safe.
+     */
+    class MonotonicBufferResource : public MemoryResource {
+    private:
+        class Chunk {
+        public:
+            Chunk* next;
+            size_t size;
+        };
+
+        MemoryResource* _upstream;
+        Chunk*          _chunks;
+        uint8_t*        _current;
+        size_t          _available;
+        size_t          _nextChunkSize;
+        size_t          _initialChunkSize;
+
+    public:
+        MonotonicBufferResource(size_t initialChunkSize = 64 * 1024, MemoryResource* upstream = newDeleteResource());
+        ~MonotonicBufferResource();
+
+        MonotonicBufferResource(const MonotonicBufferResource&) = delete;
+        MonotonicBufferResource& operator = (const MonotonicBufferResource&) = delete;
+
+    public:
+        virtual void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) override;
+        virtual void  deallocate(void* pointer, size_t bytes, size_t alignment = alignof(std::max_align_t)) override;
+
+        /**
+         * Frees every chunk, invalidating everything allocated so far.
+         */
+        void release();
+
+    private:
+        void grow(size_t minimum);
+    };
+
+    /**
+     * Standard allocator drawing from a MemoryResource, so that standard containers
+     * can use an arena. Defaults to newDeleteResource().
+     */
+    template<typename T>
+    class MemoryAllocator {
+    private:
+        MemoryResource* _resource;
+
+    public:
+        typedef T value_type;
+
+    public:
+        inline MemoryAllocator() : _resource(newDeleteResource()) {
+        }
+
+        inline MemoryAllocator(MemoryResource* resource) : _resource(resource) {
+        }
+
+        template<typename U>
+        inline MemoryAllocator(const MemoryAllocator<U>& other) : _resource(other.resource()) {
+        }
+
+    public:
+        inline T* allocate(size_t count) {
+            return static_cast<T*>(_resource->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        inline void deallocate(T* pointer, size_t count) {
+            _resource->deallocate(pointer, count * sizeof(T), alignof(T));
+        }
+
+        inline MemoryResource* resource() const { return _resource; }
+
+        template<typename U>
+        inline bool operator == (const MemoryAllocator<U>& other) const { return _resource == other.resource(); }
+
+        template<typename U>
+        inline bool operator != (const MemoryAllocator<U>& other) const { return _resource != other.resource(); }
+    };
+
+    /**
+     * Decoded resource living in a MemoryResource.
+     */
+    typedef std::vector<uint8_t, MemoryAllocator<uint8_t>> MemoryBuffer;
+
+}}
+
+#endif /* __AGIResources__MemoryResource_hpp__ */
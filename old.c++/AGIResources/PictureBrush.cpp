@@ -0,0 +1,117 @@
+//
+//  PictureBrush.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "PictureBrush.hpp"
+
+using namespace AGI::Resources;
+
+static constexpr uint16_t binaryList[] = {
+    0x8000, 0x4000, 0x2000, 0x1000, 0x800, 0x400, 0x200, 0x100,
+    0x0080, 0x0040, 0x0020, 0x0010, 0x008, 0x004, 0x002, 0x001
+};
+
+static constexpr uint8_t circleList[] = {
+    0, 1, 4, 9, 16, 25, 37, 50
+};
+
+static constexpr uint16_t circleData[] = {
+    0x8000,
+    0xE000, 0xE000, 0x0E000,
+    0x7000, 0xF800, 0x0F800, 0x0F800, 0x07000,
+    0x3800, 0x7C00, 0x0FE00, 0x0FE00, 0x0FE00, 0x07C00, 0x03800,
+    0x1C00, 0x7F00, 0x0FF80, 0x0FF80, 0x0FF80, 0x0FF80, 0x0FF80, 0x07F00, 0x01C00,
+    0x0E00, 0x3F80, 0x07FC0, 0x07FC0, 0x0FFE0, 0x0FFE0, 0x0FFE0, 0x07FC0, 0x07FC0, 0x03F80, 0x1F00, 0x0E00,
+    0x0F80, 0x3FE0, 0x07FF0, 0x07FF0, 0x0FFF8, 0x0FFF8, 0x0FFF8, 0x0FFF8, 0x0FFF8, 0x07FF0, 0x7FF0, 0x3FE0, 0x0F80,
+    0x07C0, 0x1FF0, 0x03FF8, 0x07FFC, 0x07FFC, 0x0FFFE, 0x0FFFE, 0x0FFFE, 0x0FFFE, 0x0FFFE, 0x7FFC, 0x7FFC, 0x3FF8, 0x1FF0, 0x07C0
+};
+
+static constexpr uint16_t circleDataForVersion3PenSize1[] = {
+    0x0000, 0xE000, 0x00000,
+};
+
+class PictureBrushTable
+{
+public:
+    PictureBrushStamp stamps[PictureBrush::StampCount];
+};
+
+static constexpr size_t stampIndex(uint8_t patternCode, bool version3) {
+    return (patternCode & 0x07) | ((patternCode & 0x10) >> 1) | ((patternCode & 0x20) >> 1) | (version3 ? 0x20 : 0);
+}
+
+/**
+ * Runs the per pixel plotting loop once, starting the spray texture from 1 like
+ * every plot does, and records which pixels it sets.
+ */
+static constexpr PictureBrushStamp makeStamp(uint8_t patternCode, bool version3) {
+    PictureBrushStamp stamp{};
+    uint16_t penSize  = patternCode & 0x07;
+    uint16_t penWidth = (penSize << 1) + 1;
+    bool     square   = (patternCode & 0x10) != 0;
+    bool     spray    = (patternCode & 0x20) != 0;
+    uint8_t  t        = 0x01;
+
+    const uint16_t* circlePointer = &circleData[circleList[penSize]];
+
+    if (version3 && penSize == 1)
+        circlePointer = circleDataForVersion3PenSize1;
+
+    for (uint8_t row = 0; row < penWidth; row++) {
+        uint16_t circleWord = *circlePointer++;
+        uint8_t  column     = 0;
+        bool     inRun      = false;
+
+        for (uint16_t counter = 0; counter <= penWidth; counter += 4, column++) {
+            bool plotted = false;
+
+            if (square || ((binaryList[counter >> 1] & circleWord) != 0)) {
+                if (spray) {
+                    uint8_t carry = t % 2;
+                    t = t >> 1;
+                    if (carry != 0)
+                        t = t ^ 0xB8;
+                }
+
+                plotted = !spray || (t & 0x03) == 0x01;
+            }
+
+            if (plotted && inRun) {
+                stamp.runs[stamp.runCount - 1].length++;
+            }
+            else if (plotted) {
+                PictureBrushRun& run = stamp.runs[stamp.runCount++];
+                run.x = column;
+                run.y = row;
+                run.length = 1;
+            }
+
+            inRun = plotted;
+        }
+    }
+
+    return stamp;
+}
+
+static constexpr PictureBrushTable makeTable() {
+    PictureBrushTable table{};
+
+    for (size_t index = 0; index < PictureBrush::StampCount; index++) {
+        uint8_t patternCode = (uint8_t)((index & 0x07) | ((index & 0x08) << 1) | ((index & 0x10) << 1));
+        table.stamps[index] = makeStamp(patternCode, (index & 0x20) != 0);
+    }
+
+    return table;
+}
+
+static constexpr PictureBrushTable brushTable = makeTable();
+
+static_assert(brushTable.stamps[stampIndex(0x07, false)].runCount == 15, "A large circle has one run per row");
+static_assert(brushTable.stamps[stampIndex(0x17, false)].runs[14].length == 4, "A large square is 4 pixels wide");
+
+const PictureBrushStamp& PictureBrush::stamp(uint8_t patternCode, bool version3) {
+    return brushTable.stamps[stampIndex(patternCode, version3)];
+}
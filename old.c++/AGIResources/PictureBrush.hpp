@@ -0,0 +1,54 @@
+//
+//  PictureBrush.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__PictureBrush_hpp__
+#define __AGIResources__PictureBrush_hpp__
+
+#include "AGIResources.hpp"
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Horizontal run of pixels, relative to the top left corner of a brush.
+     */
+    class PictureBrushRun
+    {
+    public:
+        uint8_t x;
+        uint8_t y;
+        uint8_t length;
+    };
+
+    /**
+     * Pixels plotted by one brush, as runs. A brush has at most 15 rows of at most
+     * 4 pixels, and a sprayed row breaks into at most 2 runs.
+     */
+    class PictureBrushStamp
+    {
+    public:
+        static const size_t MaxRuns = 30;
+
+        uint8_t         runCount;
+        PictureBrushRun runs[MaxRuns];
+    };
+
+    /**
+     * Every brush a picture can plot with, built at compile time. The stamp
+     * depends on the pen size, circle or square shape and spray bits of the
+     * pattern code, and on the interpreter version.
+     */
+    class PictureBrush
+    {
+    public:
+        static const size_t StampCount = 64;
+
+        static const PictureBrushStamp& stamp(uint8_t patternCode, bool version3);
+    };
+
+}}
+
+#endif /* __AGIResources__PictureBrush_hpp__ */
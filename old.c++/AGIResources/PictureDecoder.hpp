@@ -13,6 +13,8 @@
 
 #include <vector>
 
+#include "Span.hpp"
+
 namespace AGI { namespace Resources {
 
     class PictureCallback {
@@ -24,10 +26,10 @@ namespace AGI { namespace Resources {
         virtual void setScreen(bool) = 0;
         virtual void setPriority(uint8_t priority) = 0;
         virtual void setPriority(bool) = 0;
-        virtual void drawYCorner(uint8_t* coordinates, size_t count) = 0;
-        virtual void drawXCorner(uint8_t* coordinates, size_t count) = 0;
-        virtual void drawLineAbsolute(uint8_t* coordinates, size_t count) = 0;
-        virtual void drawLineShort(uint8_t* coordinates, size_t count) = 0;
+        virtual void drawYCorner(const uint8_t* coordinates, size_t count) = 0;
+        virtual void drawXCorner(const uint8_t* coordinates, size_t count) = 0;
+        virtual void drawLineAbsolute(const uint8_t* coordinates, size_t count) = 0;
+        virtual void drawLineShort(const uint8_t* coordinates, size_t count) = 0;
         virtual void drawFill(uint8_t x, uint8_t y) = 0;
         virtual void setPattern(uint8_t code, uint8_t number) = 0;
         virtual void plotPattern(uint8_t x, uint8_t y) = 0;
@@ -41,15 +43,128 @@ namespace AGI { namespace Resources {
     class PictureDecoder {
     private:
         std::vector<uint8_t> _buffer;
+        Span<const uint8_t>  _data;
 
     public:
         PictureDecoder(std::vector<uint8_t>&& buffer);
         PictureDecoder(const std::vector<uint8_t>& buffer);
 
+        /**
+         * Decodes data owned by the caller, such as a buffer living in an arena,
+         * without copying it. The data must outlive the decoder.
+         */
+        PictureDecoder(Span<const uint8_t> data);
+
+        // The decoder may point into its own buffer, it cannot be copied.
+        PictureDecoder(const PictureDecoder&) = delete;
+        PictureDecoder& operator = (const PictureDecoder&) = delete;
+
     public:
+        /**
+         * Decodes up to the end command, or up to the end of the data when the
+         * picture is truncated.
+         */
         void decode(PictureCallback& callback);
+
+        /**
+         * Same as decode(), but the callback is called statically: any class with
+         * the member functions of PictureCallback will do, and they can be inlined.
+         */
+        template<typename Callback>
+        void decodeInline(Callback& callback);
     };
 
+    template<typename Callback>
+    void PictureDecoder::decodeInline(Callback& callback) {
+        const uint8_t* it     = _data.data();
+        const uint8_t* end    = it + _data.size();
+        uint8_t patternCode   = 0;
+        uint8_t patternNumber = 0;
+
+        while (it != end) {
+            uint8_t command = *it++;
+
+            switch (command) {
+            case 0xf0:
+                if (it == end)
+                    return;
+
+                callback.setColor(*it++);
+                callback.setScreen(true);
+                continue;
+            case 0xf1:
+                callback.setScreen(false);
+                continue;
+            case 0xf2:
+                if (it == end)
+                    return;
+
+                callback.setPriority(*it++);
+                callback.setPriority(true);
+                continue;
+            case 0xf3:
+                callback.setPriority(false);
+                continue;
+            case 0xf9:
+                if (it == end)
+                    return;
+
+                patternCode = *it++;
+                callback.setPattern(patternCode, patternNumber);
+                continue;
+            case 0xfc:
+                if (end - it < 2)
+                    return;
+
+                callback.setColor(*it++);
+                callback.setPriority(*it++);
+                break;
+            case 0xff:
+                callback.end();
+                return;
+            }
+
+            const uint8_t* start = it;
+            while (it != end && *it < 0xf0)
+                ++it;
+
+            switch (command) {
+            case 0xf4:
+                callback.drawYCorner(start, it - start);
+                break;
+            case 0xf5:
+                callback.drawXCorner(start, it - start);
+                break;
+            case 0xf6:
+                callback.drawLineAbsolute(start, it - start);
+                break;
+            case 0xf7:
+                callback.drawLineShort(start, it - start);
+                break;
+            case 0xf8:
+            case 0xfc:
+                for (; (it - start) >= 2; start += 2)
+                    callback.drawFill(start[0], start[1]);
+                break;
+            case 0xfa:
+                while (start != it) {
+                    if (patternCode & 0x20) {
+                        patternNumber = *start++;
+                        patternNumber >>= 1;
+                        callback.setPattern(patternCode, patternNumber);
+                    }
+
+                    if ((it - start) < 2)
+                        break;
+
+                    callback.plotPattern(start[0], start[1]);
+                    start += 2;
+                }
+                break;
+            }
+        }
+    }
+
 }}
 
 #endif /* __AGIResources__PictureDecoder_hpp__ */
@@ -0,0 +1,153 @@
+//
+//  PictureExpand.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "PictureExpand.hpp"
+
+#include <algorithm>
+
+using namespace AGI::Resources;
+
+PictureExpander::PictureExpander() {
+    reset(0);
+}
+
+void PictureExpander::reset(size_t outputLength) {
+    _state     = Command;
+    _hasNibble = false;
+    _nibble    = 0;
+    _remaining = outputLength;
+}
+
+/**
+ * Number of nibbles that can be read right now.
+ */
+size_t PictureExpander::available(const Span<const uint8_t>& input) const {
+    return (_hasNibble ? 1 : 0) + input.size() * 2;
+}
+
+/**
+ * Reads the next nibble, or a zero once the input is exhausted.
+ */
+uint8_t PictureExpander::readNibble(Span<const uint8_t>& input) {
+    if (_hasNibble) {
+        _hasNibble = false;
+        return _nibble;
+    }
+
+    if (input.empty())
+        return 0;
+
+    uint8_t byte = input[0];
+
+    input      = input.subspan(1, input.size() - 1);
+    _nibble    = byte & 0x0f;
+    _hasNibble = true;
+    return byte >> 4;
+}
+
+bool PictureExpander::expand(Span<const uint8_t>& input, Span<uint8_t>& output, bool last) {
+    while (_state != Done) {
+        if (_remaining == 0) {
+            _state = Done;
+            break;
+        }
+
+        if (output.empty())
+            return false;
+
+        if (_state == Command) {
+            // Half a byte left still starts one more command, completed by padding.
+            if (available(input) == 0) {
+                if (!last)
+                    return false;
+
+                _state = Done;
+                break;
+            }
+
+            if (available(input) < 2 && !last)
+                return false;
+
+            uint8_t high = readNibble(input);
+            uint8_t byte = (uint8_t)((high << 4) | readNibble(input));
+
+            output[0]  = byte;
+            output     = output.subspan(1, output.size() - 1);
+            _remaining--;
+
+            if (byte == 0xf0 || byte == 0xf2)
+                _state = Argument;
+            else if (byte == 0xff)
+                _state = Done;
+        }
+        else {
+            if (available(input) < 1 && !last)
+                return false;
+
+            output[0]  = readNibble(input);
+            output     = output.subspan(1, output.size() - 1);
+            _remaining--;
+            _state     = Command;
+        }
+    }
+
+    return true;
+}
+
+bool AGI::Resources::PictureExpand(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize) {
+    PictureExpander      expander;
+    Span<const uint8_t>  in(input, inputSize);
+    Span<uint8_t>        out(output, outputSize);
+
+    expander.reset(outputSize);
+    expander.expand(in, out, true);
+    return out.empty();
+}
+
+bool AGI::Resources::PictureCompress(const uint8_t* input, size_t inputSize, std::vector<uint8_t>& output) {
+    bool    hasNibble = false;
+    uint8_t nibble    = 0;
+
+    output.clear();
+    output.reserve(inputSize);
+
+    auto writeNibble = [&output, &hasNibble, &nibble](uint8_t value) {
+        if (!hasNibble) {
+            nibble    = value << 4;
+            hasNibble = true;
+        }
+        else {
+            output.push_back(nibble | value);
+            hasNibble = false;
+        }
+    };
+
+    for (size_t i = 0; i < inputSize; i++) {
+        uint8_t byte = input[i];
+
+        writeNibble(byte >> 4);
+        writeNibble(byte & 0x0f);
+
+        if ((byte == 0xf0 || byte == 0xf2) && (i + 1) < inputSize) {
+            if (input[++i] > 0x0f)
+                return false;
+
+            writeNibble(input[i]);
+        }
+        else if (byte == 0xff) {
+            if ((i + 1) != inputSize)
+                return false;
+
+            break;
+        }
+    }
+
+    if (hasNibble)
+        writeNibble(0);
+
+    return true;
+}
@@ -0,0 +1,73 @@
+//
+//  PictureExpand.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__PictureExpand_hpp__
+#define __AGIResources__PictureExpand_hpp__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "Span.hpp"
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Resumable decoder for the nibble packing of version 3 pictures, where the
+     * color and priority following 0xf0 and 0xf2 are stored on 4 bits. The packed
+     * input can be handed over in chunks of any size and the output is produced
+     * incrementally, the position in the nibble stream is kept in the object.
+     */
+    class PictureExpander {
+    private:
+        enum State {
+            Command,
+            Argument,
+            Done,
+        };
+
+        State   _state;
+        bool    _hasNibble;     // Low nibble of the last input byte not consumed yet
+        uint8_t _nibble;
+        size_t  _remaining;     // Bytes of output still expected
+
+    public:
+        PictureExpander();
+
+        /**
+         * Starts a new stream that decodes to at most outputLength bytes.
+         */
+        void reset(size_t outputLength);
+
+        /**
+         * Consumes input and fills output, advancing both spans past what was used.
+         * It stops when output is full or when input runs out; pass last once the
+         * final chunk of input has been given. Returns true once the stream is
+         * finished, either on the 0xff end marker or at the end of the input.
+         */
+        bool expand(Span<const uint8_t>& input, Span<uint8_t>& output, bool last);
+
+        inline bool finished() const { return _state == Done; }
+
+    private:
+        size_t available(const Span<const uint8_t>& input) const;
+        uint8_t readNibble(Span<const uint8_t>& input);
+    };
+
+    bool PictureExpand(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize);
+
+    /**
+     * Packs a picture the way PictureExpander reads it back. Returns false when the
+     * picture cannot be packed: a color or priority that does not fit on 4 bits,
+     * or data following the 0xff end marker.
+     */
+    bool PictureCompress(const uint8_t* input, size_t inputSize, std::vector<uint8_t>& output);
+
+}}
+
+#endif /* __AGIResources__PictureExpand_hpp__ */
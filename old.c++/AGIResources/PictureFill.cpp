@@ -0,0 +1,143 @@
+//
+//  PictureFill.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "PictureFill.hpp"
+
+#include <string.h>
+
+using namespace AGI::Resources;
+
+static inline uint64_t broadcast(uint8_t value) {
+    return 0x0101010101010101ull * value;
+}
+
+static inline uint64_t load64(const uint8_t* data) {
+    uint64_t word;
+
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+/**
+ * Returns the first position in [from, to) whose value differs from value, or to.
+ * Whole words are skipped while they only hold value.
+ */
+static inline size_t findDifferent(const uint8_t* row, size_t from, size_t to, uint8_t value) {
+    uint64_t pattern = broadcast(value);
+
+    while (from + 8 <= to && load64(row + from) == pattern)
+        from += 8;
+
+    while (from < to && row[from] == value)
+        from++;
+
+    return from;
+}
+
+/**
+ * Returns the first position in [from, to) holding value, or to. Words are skipped
+ * while none of their bytes is value.
+ */
+static inline size_t findEqual(const uint8_t* row, size_t from, size_t to, uint8_t value) {
+    uint64_t pattern = broadcast(value);
+
+    while (from + 8 <= to) {
+        uint64_t x = load64(row + from) ^ pattern;
+
+        // Non-zero when one of the bytes of x is zero.
+        if ((x - 0x0101010101010101ull) & ~x & 0x8080808080808080ull)
+            break;
+
+        from += 8;
+    }
+
+    while (from < to && row[from] != value)
+        from++;
+
+    return from;
+}
+
+/**
+ * Returns the lowest position l, not below to, such that [l, from) only holds value.
+ */
+static inline size_t findDifferentBackward(const uint8_t* row, size_t from, size_t to, uint8_t value) {
+    uint64_t pattern = broadcast(value);
+
+    while (from >= to + 8 && load64(row + from - 8) == pattern)
+        from -= 8;
+
+    while (from > to && row[from - 1] == value)
+        from--;
+
+    return from;
+}
+
+PictureFiller::PictureFiller() : _queue(64), _head(0), _count(0) {
+}
+
+void PictureFiller::push(size_t offset) {
+    if (_count == _queue.size()) {
+        std::vector<uint16_t> queue(_queue.size() * 2);
+
+        for (size_t index = 0; index < _count; index++)
+            queue[index] = _queue[(_head + index) & (_queue.size() - 1)];
+
+        _queue.swap(queue);
+        _head = 0;
+    }
+
+    _queue[(_head + _count++) & (_queue.size() - 1)] = (uint16_t)offset;
+}
+
+/**
+ * Queues one seed per run of fillable pixels of the row within [start, end).
+ */
+void PictureFiller::queueRuns(const uint8_t* row, uint8_t fillable, size_t start, size_t end, size_t rowOffset) {
+    for (;;) {
+        start = findEqual(row, start, end, fillable);
+        if (start == end)
+            return;
+
+        push(rowOffset + start);
+        start = findDifferent(row, start, end, fillable);
+    }
+}
+
+void PictureFiller::fill(const uint8_t* test, uint8_t fillable, uint8_t* screen, uint8_t screenColor, uint8_t* priority, uint8_t priorityColor, uint8_t x, uint8_t y) {
+    if (x >= PictureWidth || y >= PictureHeight)
+        return;
+
+    _head  = 0;
+    _count = 0;
+    push(y * PictureWidth + x);
+
+    while (_count) {
+        size_t offset = _queue[_head];
+
+        _head = (_head + 1) & (_queue.size() - 1);
+        _count--;
+
+        if (test[offset] != fillable)
+            continue;
+
+        size_t         rowY      = offset / PictureWidth;
+        size_t         rowOffset = rowY * PictureWidth;
+        const uint8_t* row       = test + rowOffset;
+        size_t         start     = findDifferentBackward(row, offset - rowOffset, 0, fillable);
+        size_t         end       = findDifferent(row, offset - rowOffset + 1, PictureWidth, fillable);
+
+        if (screen)
+            memset(screen + rowOffset + start, screenColor, end - start);
+        if (priority)
+            memset(priority + rowOffset + start, priorityColor, end - start);
+
+        if (rowY > 0)
+            queueRuns(row - PictureWidth, fillable, start, end, rowOffset - PictureWidth);
+        if (rowY + 1 < PictureHeight)
+            queueRuns(row + PictureWidth, fillable, start, end, rowOffset + PictureWidth);
+    }
+}
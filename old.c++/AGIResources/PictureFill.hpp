@@ -0,0 +1,51 @@
+//
+//  PictureFill.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__PictureFill_hpp__
+#define __AGIResources__PictureFill_hpp__
+
+#include "AGIResources.hpp"
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Scanline flood fill working directly on PictureWidth x PictureHeight planes.
+     *
+     * A pixel is fillable while its value in the tested plane equals the fillable
+     * value, and painting it always makes it unfillable. The filled area is then
+     * the 4-connected region of fillable pixels around the seed, whatever the order
+     * runs are visited in, which is what the pixel by pixel fill of PictureTracer
+     * produces too.
+     *
+     * Runs of fillable pixels are found 8 bytes at a time and painted with memset.
+     * Pending seeds are kept in a ring buffer that is reused from one fill to the
+     * next.
+     */
+    class PictureFiller {
+    private:
+        std::vector<uint16_t> _queue;
+        size_t                _head;
+        size_t                _count;
+
+    public:
+        PictureFiller();
+
+    public:
+        /**
+         * Fills from (x, y). The screen and priority planes are painted when they
+         * are not null; test must be one of them.
+         */
+        void fill(const uint8_t* test, uint8_t fillable, uint8_t* screen, uint8_t screenColor, uint8_t* priority, uint8_t priorityColor, uint8_t x, uint8_t y);
+
+    private:
+        void push(size_t offset);
+        void queueRuns(const uint8_t* row, uint8_t fillable, size_t start, size_t end, size_t rowOffset);
+    };
+
+}}
+
+#endif /* __AGIResources__PictureFill_hpp__ */
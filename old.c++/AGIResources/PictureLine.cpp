@@ -0,0 +1,107 @@
+//
+//  PictureLine.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "PictureLine.hpp"
+
+using namespace AGI::Resources;
+
+static const int PathSide = (PictureLine::MaxDisplacement * 2) + 1;
+
+static constexpr int pathIndex(int dx, int dy) {
+    return ((dy + PictureLine::MaxDisplacement) * PathSide) + dx + PictureLine::MaxDisplacement;
+}
+
+class PictureLineTable
+{
+public:
+    PictureLinePath paths[PathSide * PathSide];
+};
+
+/**
+ * Steps from (0, 0) to (dx, dy) like the tracer's Bresenham loop does, which only
+ * depends on the displacement once the endpoints need no clipping.
+ */
+static constexpr PictureLinePath makePath(int dx, int dy) {
+    PictureLinePath path{};
+    int x = 0, y = 0;
+    int stepX = 1, stepY = 1;
+    int deltaX = dx, deltaY = dy;
+
+    if (deltaY < 0) {
+        stepY = -1;
+        deltaY = -deltaY;
+    }
+
+    if (deltaX < 0) {
+        stepX = -1;
+        deltaX = -deltaX;
+    }
+
+    int i        = deltaX;
+    int detdelta = deltaX;
+    int errorX   = 0;
+    int errorY   = deltaX / 2;
+
+    if (deltaY > deltaX) {
+        i = deltaY;
+        detdelta = deltaY;
+        errorX = deltaY / 2;
+        errorY = 0;
+    }
+
+    for (; i > 0; i--) {
+        errorY += deltaY;
+        if (errorY >= detdelta) {
+            errorY -= detdelta;
+            y += stepY;
+        }
+
+        errorX += deltaX;
+        if (errorX >= detdelta) {
+            errorX -= detdelta;
+            x += stepX;
+        }
+
+        path.x[path.count] = (int8_t)x;
+        path.y[path.count] = (int8_t)y;
+        path.count++;
+    }
+
+    return path;
+}
+
+static constexpr PictureLineTable makeTable() {
+    PictureLineTable table{};
+
+    for (int dy = -PictureLine::MaxDisplacement; dy <= PictureLine::MaxDisplacement; dy++) {
+        for (int dx = -PictureLine::MaxDisplacement; dx <= PictureLine::MaxDisplacement; dx++)
+            table.paths[pathIndex(dx, dy)] = makePath(dx, dy);
+    }
+
+    return table;
+}
+
+static constexpr PictureLineTable lineTable = makeTable();
+
+static constexpr bool endsAtDisplacement() {
+    for (int dy = -PictureLine::MaxDisplacement; dy <= PictureLine::MaxDisplacement; dy++) {
+        for (int dx = -PictureLine::MaxDisplacement; dx <= PictureLine::MaxDisplacement; dx++) {
+            const PictureLinePath& path = lineTable.paths[pathIndex(dx, dy)];
+
+            if ((dx || dy) && (path.x[path.count - 1] != dx || path.y[path.count - 1] != dy))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static_assert(endsAtDisplacement(), "Every line path must end on its displacement");
+
+const PictureLinePath& PictureLine::path(int dx, int dy) {
+    return lineTable.paths[pathIndex(dx, dy)];
+}
@@ -0,0 +1,43 @@
+//
+//  PictureLine.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__PictureLine_hpp__
+#define __AGIResources__PictureLine_hpp__
+
+#include "AGIResources.hpp"
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Pixels a line plots after its starting point, relative to it.
+     */
+    class PictureLinePath
+    {
+    public:
+        static const size_t MaxCount = 7;
+
+        uint8_t count;
+        int8_t  x[MaxCount];
+        int8_t  y[MaxCount];
+    };
+
+    /**
+     * Paths of every line a short relative line command can draw, from -7 to 7
+     * pixels on each axis, built at compile time with the same stepping as
+     * PictureTracer's line drawing.
+     */
+    class PictureLine
+    {
+    public:
+        static const int MaxDisplacement = 7;
+
+        static const PictureLinePath& path(int dx, int dy);
+    };
+
+}}
+
+#endif /* __AGIResources__PictureLine_hpp__ */
@@ -9,6 +9,9 @@
 
 #include "AGIResources.hpp"
 
+#include <assert.h>
+#include <string.h>
+
 using namespace AGI::Resources;
 
 PictureRasterizer::PictureRasterizer(const GameInfo& info, uint8_t* screen, uint8_t* priority, bool clear) : PictureTracer(info), _screen(screen), _priority(priority) {
@@ -41,3 +44,39 @@ void PictureRasterizer::setPixelPriority(uint8_t x, uint8_t y, uint8_t priority)
     assert(y < PictureHeight);
     _priority[(y * PictureWidth) + x] = priority;
 }
+
+void PictureRasterizer::setRowScreen(uint8_t x, uint8_t y, size_t length, uint8_t color) {
+    assert(x + length <= PictureWidth);
+    assert(y < PictureHeight);
+    memset(_screen + (y * PictureWidth) + x, color, length);
+}
+
+void PictureRasterizer::setRowPriority(uint8_t x, uint8_t y, size_t length, uint8_t priority) {
+    assert(x + length <= PictureWidth);
+    assert(y < PictureHeight);
+    memset(_priority + (y * PictureWidth) + x, priority, length);
+}
+
+void PictureRasterizer::setColumnScreen(uint8_t x, uint8_t y, size_t length, uint8_t color) {
+    assert(x < PictureWidth);
+    assert(y + length <= PictureHeight);
+
+    for (uint8_t* pixel = _screen + (y * PictureWidth) + x; length; length--, pixel += PictureWidth)
+        *pixel = color;
+}
+
+void PictureRasterizer::setColumnPriority(uint8_t x, uint8_t y, size_t length, uint8_t priority) {
+    assert(x < PictureWidth);
+    assert(y + length <= PictureHeight);
+
+    for (uint8_t* pixel = _priority + (y * PictureWidth) + x; length; length--, pixel += PictureWidth)
+        *pixel = priority;
+}
+
+uint8_t* PictureRasterizer::screenPlane() {
+    return _screen;
+}
+
+uint8_t* PictureRasterizer::priorityPlane() {
+    return _priority;
+}
@@ -10,6 +10,8 @@
 
 #include "PictureTracer.hpp"
 
+#include <string.h>
+
 namespace AGI { namespace Resources {
 
     class GameInfo;
@@ -30,6 +32,49 @@ namespace AGI { namespace Resources {
         virtual void setPixelScreen(uint8_t x, uint8_t y, uint8_t color) override;
         virtual uint8_t pixelPriority(uint8_t x, uint8_t y) override;
         virtual void setPixelPriority(uint8_t x, uint8_t y, uint8_t priority) override;
+
+        virtual void setRowScreen(uint8_t x, uint8_t y, size_t length, uint8_t color) override;
+        virtual void setRowPriority(uint8_t x, uint8_t y, size_t length, uint8_t priority) override;
+        virtual void setColumnScreen(uint8_t x, uint8_t y, size_t length, uint8_t color) override;
+        virtual void setColumnPriority(uint8_t x, uint8_t y, size_t length, uint8_t priority) override;
+
+        virtual uint8_t* screenPlane() override;
+        virtual uint8_t* priorityPlane() override;
+    };
+
+    /**
+     * Same as PictureRasterizer, but traced through PictureTracerT: decoded with
+     * PictureDecoder::decodeInline(), no pixel goes through a virtual call. The
+     * planes are drawn as they are, the caller initializes them.
+     */
+    class StaticPictureRasterizer : public PictureTracerT<StaticPictureRasterizer> {
+    private:
+        uint8_t* _screen;
+        uint8_t* _priority;
+
+    public:
+        inline StaticPictureRasterizer(const GameInfo& info, uint8_t* screen, uint8_t* priority) : PictureTracerT<StaticPictureRasterizer>(info), _screen(screen), _priority(priority) {
+        }
+
+    public:
+        inline uint8_t pixelScreen(uint8_t x, uint8_t y) const { return _screen[(y * PictureWidth) + x]; }
+        inline uint8_t pixelPriority(uint8_t x, uint8_t y) const { return _priority[(y * PictureWidth) + x]; }
+        inline void setPixelScreen(uint8_t x, uint8_t y, uint8_t color) { _screen[(y * PictureWidth) + x] = color; }
+        inline void setPixelPriority(uint8_t x, uint8_t y, uint8_t priority) { _priority[(y * PictureWidth) + x] = priority; }
+
+        inline void setRowScreen(uint8_t x, uint8_t y, size_t length, uint8_t color) { memset(_screen + (y * PictureWidth) + x, color, length); }
+        inline void setRowPriority(uint8_t x, uint8_t y, size_t length, uint8_t priority) { memset(_priority + (y * PictureWidth) + x, priority, length); }
+        inline void setColumnScreen(uint8_t x, uint8_t y, size_t length, uint8_t color) { setColumn(_screen + (y * PictureWidth) + x, length, color); }
+        inline void setColumnPriority(uint8_t x, uint8_t y, size_t length, uint8_t priority) { setColumn(_priority + (y * PictureWidth) + x, length, priority); }
+
+        inline uint8_t* screenPlane() { return _screen; }
+        inline uint8_t* priorityPlane() { return _priority; }
+
+    private:
+        static inline void setColumn(uint8_t* pixel, size_t length, uint8_t value) {
+            for (; length; length--, pixel += PictureWidth)
+                *pixel = value;
+        }
     };
 
 }}
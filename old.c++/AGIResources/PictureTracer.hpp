@@ -9,24 +9,19 @@
 #define __AGIResources__PictureTracer_hpp__
 
 #include "PictureDecoder.hpp"
+#include "PictureTracerT.hpp"
 
 namespace AGI { namespace Resources {
 
     class GameInfo;
+    class PictureTracer;
+
+    extern template class PictureTracerT<PictureTracer, PictureCallback>;
 
     /**
      * This class transform a picture instructions in a pixel instructinos.
      */
-    class PictureTracer : public PictureCallback {
-    private:
-        bool _screen;
-        uint8_t _screenColor;
-        bool _priority;
-        uint8_t _priorityColor;
-        uint8_t _patternCode;
-        uint8_t _patternNumber;
-        bool _version3;
-
+    class PictureTracer : public PictureTracerT<PictureTracer, PictureCallback> {
     public:
         PictureTracer(const GameInfo& info);
 
@@ -36,24 +31,22 @@ namespace AGI { namespace Resources {
         virtual uint8_t pixelPriority(uint8_t x, uint8_t y) = 0;
         virtual void setPixelPriority(uint8_t x, uint8_t y, uint8_t priority) = 0;
 
-    public:
-        virtual void setColor(uint8_t color) override;
-        virtual void setScreen(bool) override;
-        virtual void setPriority(uint8_t priority) override;
-        virtual void setPriority(bool) override;
-        virtual void drawYCorner(uint8_t* coordinates, size_t count) override;
-        virtual void drawXCorner(uint8_t* coordinates, size_t count) override;
-        virtual void drawLineAbsolute(uint8_t* coordinates, size_t count) override;
-        virtual void drawLineShort(uint8_t* coordinates, size_t count) override;
-        virtual void drawFill(uint8_t x, uint8_t y) override;
-        virtual void setPattern(uint8_t code, uint8_t number) override;
-        virtual void plotPattern(uint8_t x, uint8_t y) override;
-        virtual void end() override;
-
-    private:
-        void putPixel(uint8_t x, uint8_t y);
-        void drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
-        bool drawFillCheck(uint8_t x, uint8_t y);
+        /**
+         * Sets length pixels to the right of, or below, (x, y), all within the
+         * picture. By default they are set one at a time.
+         */
+        virtual void setRowScreen(uint8_t x, uint8_t y, size_t length, uint8_t color);
+        virtual void setRowPriority(uint8_t x, uint8_t y, size_t length, uint8_t priority);
+        virtual void setColumnScreen(uint8_t x, uint8_t y, size_t length, uint8_t color);
+        virtual void setColumnPriority(uint8_t x, uint8_t y, size_t length, uint8_t priority);
+
+        /**
+         * Tracers drawing into memory return their PictureWidth x PictureHeight
+         * planes, fills then run directly on them. Others return nullptr and are
+         * filled pixel by pixel through the accessors above.
+         */
+        virtual uint8_t* screenPlane();
+        virtual uint8_t* priorityPlane();
     };
 
 }}
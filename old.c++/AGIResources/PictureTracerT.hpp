@@ -0,0 +1,489 @@
+//
+//  PictureTracerT.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__PictureTracerT_hpp__
+#define __AGIResources__PictureTracerT_hpp__
+
+#include "AGIResources.hpp"
+#include "GameInfo.hpp"
+#include "PictureBrush.hpp"
+#include "PictureFill.hpp"
+#include "PictureLine.hpp"
+
+#include <assert.h>
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Base of the tracers that are only ever called statically.
+     */
+    class PictureStaticCallback {
+    };
+
+    /**
+     * Turns picture instructions into pixels, like PictureTracer, but calls its
+     * target statically. Target derives from PictureTracerT<Target> and provides:
+     *
+     *   uint8_t  pixelScreen(uint8_t x, uint8_t y);
+     *   void     setPixelScreen(uint8_t x, uint8_t y, uint8_t color);
+     *   uint8_t  pixelPriority(uint8_t x, uint8_t y);
+     *   void     setPixelPriority(uint8_t x, uint8_t y, uint8_t priority);
+     *   void     setRowScreen(uint8_t x, uint8_t y, size_t length, uint8_t color);
+     *   void     setRowPriority(uint8_t x, uint8_t y, size_t length, uint8_t priority);
+     *   void     setColumnScreen(uint8_t x, uint8_t y, size_t length, uint8_t color);
+     *   void     setColumnPriority(uint8_t x, uint8_t y, size_t length, uint8_t priority);
+     *   uint8_t* screenPlane();
+     *   uint8_t* priorityPlane();
+     *
+     * Pixels are only set within the picture. Horizontal and vertical lines, which
+     * make up most corner commands, are set as row and column spans, and short
+     * relative lines follow precomputed paths. Together with
+     * PictureDecoder::decodeInline(), the whole decode, trace and raster path can
+     * be inlined into a single loop.
+     *
+     * PictureTracer is the instantiation going through virtual functions. Its
+     * Callback is PictureCallback, whose functions are then implemented directly
+     * by the ones below, without anything forwarding to them.
+     */
+    template<typename Target, typename Callback = PictureStaticCallback>
+    class PictureTracerT : public Callback {
+    private:
+        bool _screen;
+        uint8_t _screenColor;
+        bool _priority;
+        uint8_t _priorityColor;
+        uint8_t _patternCode;
+        uint8_t _patternNumber;
+        bool _version3;
+        PictureFiller _filler;
+
+    public:
+        PictureTracerT(const GameInfo& info);
+
+    public:
+        void setColor(uint8_t color);
+        void setScreen(bool);
+        void setPriority(uint8_t priority);
+        void setPriority(bool);
+        void drawYCorner(const uint8_t* coordinates, size_t count);
+        void drawXCorner(const uint8_t* coordinates, size_t count);
+        void drawLineAbsolute(const uint8_t* coordinates, size_t count);
+        void drawLineShort(const uint8_t* coordinates, size_t count);
+        void drawFill(uint8_t x, uint8_t y);
+        void setPattern(uint8_t code, uint8_t number);
+        void plotPattern(uint8_t x, uint8_t y);
+        void end();
+
+    private:
+        inline Target& target() { return static_cast<Target&>(*this); }
+
+        void putPixel(uint8_t x, uint8_t y);
+        void putRow(uint8_t x, uint8_t y, size_t length);
+        void putColumn(uint8_t x, uint8_t y, size_t length);
+        void drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+        void drawLineClipped(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+        bool drawFillCheck(uint8_t x, uint8_t y);
+
+        template <typename T>
+        static inline T clip(T value, T min, T max) {
+            if (value < min)
+                return min;
+            else if (value > max)
+                return max;
+            return value;
+        }
+
+        template <typename T>
+        static inline void swap(T& v1, T& v2) {
+            T temp = v2;
+            v2 = v1;
+            v1 = temp;
+        }
+    };
+
+    template<typename Target, typename Callback>
+    PictureTracerT<Target, Callback>::PictureTracerT(const GameInfo& info) : _screen(false), _screenColor(0), _priority(false), _priorityColor(0), _patternCode(0), _patternNumber(0) {
+        _version3 = info.version() >= 0x3000;
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::setScreen(bool screen) {
+        _screen = screen;
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::setColor(uint8_t color) {
+        _screenColor = color;
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::setPriority(bool priority) {
+        _priority = priority;
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::setPriority(uint8_t priority) {
+        _priorityColor = priority;
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::putPixel(uint8_t x, uint8_t y) {
+        if (x >= PictureWidth || y >= PictureHeight)
+            return;
+
+        if (_screen)
+            target().setPixelScreen(x, y, _screenColor);
+        if (_priority)
+            target().setPixelPriority(x, y, _priorityColor);
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::putRow(uint8_t x, uint8_t y, size_t length) {
+        assert(x + length <= PictureWidth && y < PictureHeight);
+
+        if (_screen)
+            target().setRowScreen(x, y, length, _screenColor);
+        if (_priority)
+            target().setRowPriority(x, y, length, _priorityColor);
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::putColumn(uint8_t x, uint8_t y, size_t length) {
+        assert(x < PictureWidth && y + length <= PictureHeight);
+
+        if (_screen)
+            target().setColumnScreen(x, y, length, _screenColor);
+        if (_priority)
+            target().setColumnPriority(x, y, length, _priorityColor);
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2) {
+        x1 = clip<uint8_t>(x1, 0, PictureWidth - 1);
+        x2 = clip<uint8_t>(x2, 0, PictureWidth - 1);
+        y1 = clip<uint8_t>(y1, 0, PictureHeight - 1);
+        y2 = clip<uint8_t>(y2, 0, PictureHeight - 1);
+        drawLineClipped(x1, y1, x2, y2);
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::drawLineClipped(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2) {
+        int i, x, y, deltaX, deltaY, stepX, stepY, errorX, errorY, detdelta;
+
+        // Vertical line
+
+        if (x1 == x2) {
+            if (y1 > y2)
+                swap<uint8_t>(y1, y2);
+
+            putColumn(x1, y1, y2 - y1 + 1);
+            return;
+        }
+
+        // Horizontal line
+
+        if (y1 == y2) {
+            if (x1 > x2)
+                swap<uint8_t>(x1, x2);
+
+            putRow(x1, y1, x2 - x1 + 1);
+            return;
+        }
+
+        y = y1;
+        x = x1;
+
+        stepY = 1;
+        deltaY = y2 - y1;
+        if (deltaY < 0) {
+            stepY = -1;
+            deltaY = -deltaY;
+        }
+
+        stepX = 1;
+        deltaX = x2 - x1;
+        if (deltaX < 0) {
+            stepX = -1;
+            deltaX = -deltaX;
+        }
+
+        if (deltaY > deltaX) {
+            i = deltaY;
+            detdelta = deltaY;
+            errorX = deltaY / 2;
+            errorY = 0;
+        }
+        else {
+            i = deltaX;
+            detdelta = deltaX;
+            errorX = 0;
+            errorY = deltaX / 2;
+        }
+
+        putPixel(x, y);
+
+        do {
+            errorY += deltaY;
+            if (errorY >= detdelta) {
+                errorY -= detdelta;
+                y += stepY;
+            }
+
+            errorX += deltaX;
+            if (errorX >= detdelta) {
+                errorX -= detdelta;
+                x += stepX;
+            }
+
+            putPixel(x, y);
+            i--;
+        } while (i > 0);
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::drawYCorner(const uint8_t* coordinates, size_t count) {
+        if (count < 2)
+            return;
+
+        uint8_t x1, x2, y1, y2;
+        x1 = coordinates[0];
+        y1 = coordinates[1];
+        putPixel(x1, y1);
+
+        const uint8_t* end = coordinates + count;
+        coordinates += 2;
+
+        while (coordinates != end) {
+            y2 = *coordinates++;
+            drawLine(x1, y1, x1, y2);
+
+            if (coordinates == end)
+                break;
+
+            y1 = y2;
+            x2 = *coordinates++;
+            drawLine(x1, y1, x2, y1);
+            x1 = x2;
+        }
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::drawXCorner(const uint8_t* coordinates, size_t count) {
+        if (count < 2)
+            return;
+
+        uint8_t x1, x2, y1, y2;
+        x1 = coordinates[0];
+        y1 = coordinates[1];
+        putPixel(x1, y1);
+
+        const uint8_t* end = coordinates + count;
+        coordinates += 2;
+
+        while (coordinates != end) {
+            x2 = *coordinates++;
+            drawLine(x1, y1, x2, y1);
+
+            if (coordinates == end)
+                break;
+
+            x1 = x2;
+            y2 = *coordinates++;
+            drawLine(x1, y1, x1, y2);
+            y1 = y2;
+        }
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::drawLineAbsolute(const uint8_t* coordinates, size_t count) {
+        if (count < 2)
+            return;
+
+        uint8_t x1, x2, y1, y2;
+        x1 = coordinates[0];
+        y1 = coordinates[1];
+        putPixel(x1, y1);
+
+        const uint8_t* end = coordinates + count;
+        coordinates += 2;
+
+        while (coordinates != end) {
+            x2 = *coordinates++;
+            if (coordinates == end)
+                break;
+
+            y2 = *coordinates++;
+            drawLine(x1, y1, x2, y2);
+            x1 = x2;
+            y1 = y2;
+        }
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::drawLineShort(const uint8_t* coordinates, size_t count) {
+        if (count < 2)
+            return;
+
+        uint8_t x1, y1, disp;
+        int8_t dx, dy;
+        x1 = coordinates[0];
+        y1 = coordinates[1];
+        putPixel(x1, y1);
+
+        const uint8_t* end = coordinates + count;
+        coordinates += 2;
+
+        while (coordinates != end) {
+            disp = *coordinates++;
+
+            dx = ((disp & 0xf0) >> 4) & 0x0f;
+            dy = (disp & 0x0f);
+
+            if (dx & 0x08)
+                dx = -(dx & 0x07);
+            if (dy & 0x08)
+                dy = -(dy & 0x07);
+
+            int x2 = x1 + dx;
+            int y2 = y1 + dy;
+
+            if (x1 >= PictureWidth || y1 >= PictureHeight || x2 < 0 || x2 >= PictureWidth || y2 < 0 || y2 >= PictureHeight) {
+                drawLine(x1, y1, x1 + dx, y1 + dy);
+            }
+            else if (dx == 0 || dy == 0) {
+                drawLineClipped(x1, y1, x2, y2);
+            }
+            else {
+                // (x1, y1) is already plotted, by the previous line or above.
+                const PictureLinePath& path = PictureLine::path(dx, dy);
+
+                for (size_t index = 0; index < path.count; index++)
+                    putPixel(x1 + path.x[index], y1 + path.y[index]);
+            }
+
+            x1 += dx;
+            y1 += dy;
+        }
+    }
+
+    template<typename Target, typename Callback>
+    bool PictureTracerT<Target, Callback>::drawFillCheck(uint8_t x, uint8_t y) {
+        if (x >= PictureWidth || y >= PictureHeight)
+            return false;
+
+        uint8_t screenColor    = target().pixelScreen(x, y);
+        uint8_t screenPriority = target().pixelPriority(x, y);
+
+        if (!_priority && _screen && _screenColor != 15)
+            return (screenColor == 15);
+
+        if (_priority && !_screen && _priorityColor != 4)
+            return screenPriority == 4;
+
+        return (_screen && screenColor == 15 && _screenColor != 15);
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::drawFill(uint8_t x, uint8_t y) {
+        if (!_screen && !_priority)
+            return;
+
+        uint8_t* screen   = target().screenPlane();
+        uint8_t* priority = target().priorityPlane();
+
+        if (screen && priority) {
+            // Same rules as drawFillCheck(): white screen pixels are filled when the
+            // screen is drawn in another color, otherwise red priority pixels are
+            // filled when only the priority is drawn in another color.
+            if (_screen && _screenColor != 15)
+                _filler.fill(screen, 15, screen, _screenColor, _priority ? priority : nullptr, _priorityColor, x, y);
+            else if (_priority && !_screen && _priorityColor != 4)
+                _filler.fill(priority, 4, nullptr, _screenColor, priority, _priorityColor, x, y);
+
+            return;
+        }
+
+        std::vector<std::pair<uint8_t, uint8_t>> stack;
+        size_t                                   head = 0;
+
+        stack.emplace_back(x, y);
+
+        while (head < stack.size()) {
+            std::pair<uint8_t, uint8_t> p = stack[head++];
+
+            if (!drawFillCheck(p.first, p.second))
+                continue;
+
+            unsigned int c;
+            bool newspanUp, newspanDown;
+
+            for (c = p.first - 1; drawFillCheck(c, p.second); c--)
+                ;
+
+            newspanUp = newspanDown = true;
+            for (c++; drawFillCheck(c, p.second); c++) {
+                putPixel(c, p.second);
+                if (drawFillCheck(c, p.second - 1)) {
+                    if (newspanUp) {
+                        stack.emplace_back(c, p.second - 1);
+                        newspanUp = false;
+                    }
+                }
+                else {
+                    newspanUp = true;
+                }
+
+                if (drawFillCheck(c, p.second + 1)) {
+                    if (newspanDown) {
+                        stack.emplace_back(c, p.second + 1);
+                        newspanDown = false;
+                    }
+                }
+                else {
+                    newspanDown = true;
+                }
+            }
+        }
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::setPattern(uint8_t code, uint8_t number) {
+        _patternCode = code;
+        _patternNumber = number;
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::plotPattern(uint8_t x, uint8_t y) {
+        const PictureBrushStamp& stamp = PictureBrush::stamp(_patternCode, _version3);
+        int penSize = _patternCode & 0x07;
+
+        // The brush is centered on (x, y), in half pixels horizontally, and kept
+        // within the picture, except for the columns past the right edge.
+        int penX = clip<int>((x * 2) - penSize, 0, (PictureWidth * 2) - (2 * penSize)) / 2;
+        int penY = clip<int>(y - penSize, 0, (PictureHeight - 1) - (2 * penSize));
+
+        for (size_t index = 0; index < stamp.runCount; index++) {
+            const PictureBrushRun& run = stamp.runs[index];
+            int    runX   = penX + run.x;
+            size_t length = run.length;
+
+            if (runX >= PictureWidth)
+                continue;
+            if (runX + length > PictureWidth)
+                length = PictureWidth - runX;
+
+            putRow((uint8_t)runX, (uint8_t)(penY + run.y), length);
+        }
+    }
+
+    template<typename Target, typename Callback>
+    void PictureTracerT<Target, Callback>::end() {
+    }
+
+}}
+
+#endif /* __AGIResources__PictureTracerT_hpp__ */
@@ -12,6 +12,9 @@
 #include <stdlib.h>
 
 #include <string>
+#include <vector>
+
+#include "Span.hpp"
 
 #ifndef __printflike
 #define __printflike(f,e)
@@ -30,6 +33,25 @@ namespace AGI { namespace Resources {
         virtual std::vector<std::string> fileList() const = 0;
         virtual std::string fileMD5Hash(const char* fileName) const = 0;
 
+        /**
+         * Returns a view directly into the file's content, without copying it. The
+         * view stays valid for the lifetime of the platform abstraction layer. An
+         * empty view means the platform cannot provide one for this range, and the
+         * caller is expected to fall back on fileRead().
+         */
+        virtual Span<const uint8_t> fileView(const char* /* fileName */, size_t /* offset */, size_t /* length */) const { return Span<const uint8_t>(); }
+
+        /**
+         * Modification time of a file, in nanoseconds since the epoch, or -1 when the
+         * platform cannot tell. It is queried again on every call.
+         */
+        virtual int64_t fileModificationTime(const char* /* fileName */) const { return -1; }
+
+        /**
+         * Replaces the content of a file. Platforms that are read only return false.
+         */
+        virtual bool fileWrite(const char* /* fileName */, const void* /* data */, size_t /* length */) const { return false; }
+
     public:
         virtual void log(const char *, ...) const __printflike(2, 3) = 0;
     };
@@ -0,0 +1,68 @@
+//
+//  PlatformAbstractionLayer_Linux.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#include "PlatformAbstractionLayer_Linux.hpp"
+
+#include "MD5.hpp"
+
+#include <cstdarg>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <syslog.h>
+
+#include <stdexcept>
+
+using namespace AGI::Resources;
+
+PlatformAbstractionLayer_Linux::PlatformAbstractionLayer_Linux(const std::string& folder, bool useSyslog) : PlatformAbstractionLayer_POSIX(folder), _syslog(useSyslog) {
+    if (_syslog)
+        openlog("AGI", LOG_PID, LOG_USER);
+}
+
+PlatformAbstractionLayer_Linux::~PlatformAbstractionLayer_Linux() {
+    if (_syslog)
+        closelog();
+}
+
+std::string PlatformAbstractionLayer_Linux::fileMD5Hash(const char* fileName) const {
+    size_t size;
+    auto fd(descriptor(fileName, &size));
+    if (!fd)
+        throw std::runtime_error(strerror(errno));
+
+    // Hash in fixed size chunks, the memory used does not depend on the file size.
+    MD5     md5;
+    uint8_t chunk[4096];
+
+    for (size_t offset = 0; offset < size; offset += sizeof(chunk)) {
+        size_t length = size - offset;
+        if (length > sizeof(chunk))
+            length = sizeof(chunk);
+
+        if (fd->preadall(chunk, length, offset) < 0)
+            throw std::runtime_error(strerror(errno));
+
+        md5.update(chunk, length);
+    }
+
+    return md5.finalString();
+}
+
+void PlatformAbstractionLayer_Linux::log(const char *format, ...) const {
+    va_list va;
+    char buffer[2048];
+
+    va_start(va, format);
+    vsnprintf(buffer, sizeof(buffer), format, va);
+    va_end(va);
+
+    if (_syslog)
+        syslog(LOG_INFO, "%s", buffer);
+    else
+        fprintf(stderr, "AGI: %s\n", buffer);
+}
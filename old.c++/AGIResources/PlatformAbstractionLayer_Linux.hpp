@@ -0,0 +1,33 @@
+//
+//  PlatformAbstractionLayer_Linux.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__PlatformAbstractionLayer_Linux_hpp__
+#define __AGIResources__PlatformAbstractionLayer_Linux_hpp__
+
+#include "PlatformAbstractionLayer_POSIX.hpp"
+
+namespace AGI { namespace Resources {
+
+class PlatformAbstractionLayer_Linux : public PlatformAbstractionLayer_POSIX
+{
+protected:
+    bool _syslog;
+
+public:
+    PlatformAbstractionLayer_Linux(const std::string& folder, bool useSyslog = false);
+    virtual ~PlatformAbstractionLayer_Linux();
+
+public:
+    virtual std::string fileMD5Hash(const char* fileName) const override;
+
+public:
+    virtual void log(const char *, ...) const override;
+};
+
+}}
+
+#endif /* __AGIResources__PlatformAbstractionLayer_Linux_hpp__ */
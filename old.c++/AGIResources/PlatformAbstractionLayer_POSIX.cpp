@@ -11,9 +11,13 @@
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <stdarg.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <stdexcept>
 #include <vector>
 
 using namespace AGI::Resources;
@@ -46,7 +50,115 @@ ssize_t PlatformAbstractionLayer_POSIX_FileDescriptor::readall(void* data, size_
     return readed;
 }
 
-PlatformAbstractionLayer_POSIX::PlatformAbstractionLayer_POSIX(const std::string& folder) : _folder(folder) {
+ssize_t PlatformAbstractionLayer_POSIX_FileDescriptor::preadall(void* data, size_t length, size_t offset) const {
+    ssize_t readed = 0;
+
+    while (length) {
+        ssize_t thisRead = pread(_desc, data, length, (off_t)offset);
+        if (thisRead < 0) {
+            if (errno == EINTR)
+                continue;
+
+            return thisRead;
+        }
+        else if (thisRead == 0)
+            break;
+
+        data    = ((uint8_t*)data) + thisRead;
+        length -= thisRead;
+        offset += thisRead;
+        readed += thisRead;
+    }
+
+    if (length)
+        memset(data, 0, length);
+
+    return readed;
+}
+
+PlatformAbstractionLayer_POSIX_DescriptorPool::PlatformAbstractionLayer_POSIX_DescriptorPool(size_t capacity) : _capacity(capacity ? capacity : 1), _hits(0), _misses(0), _evictions(0) {
+}
+
+std::shared_ptr<PlatformAbstractionLayer_POSIX_FileDescriptor> PlatformAbstractionLayer_POSIX_DescriptorPool::acquire(const std::string& path, size_t* size) {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto it(_index.find(path));
+    if (it != _index.end()) {
+        _hits++;
+        _entries.splice(_entries.begin(), _entries, it->second);
+
+        if (size)
+            *size = it->second->size;
+
+        return it->second->descriptor;
+    }
+
+    _misses++;
+
+    int desc = open(path.c_str(), O_RDONLY);
+    if (desc < 0)
+        return nullptr;
+
+    std::shared_ptr<PlatformAbstractionLayer_POSIX_FileDescriptor> descriptor(std::make_shared<PlatformAbstractionLayer_POSIX_FileDescriptor>(desc));
+    struct stat st;
+
+    if (fstat(desc, &st))
+        return nullptr;
+
+    // Evicted descriptors stay open until their last user releases them.
+    while (_entries.size() >= _capacity) {
+        _index.erase(_entries.back().path);
+        _entries.pop_back();
+        _evictions++;
+    }
+
+    _entries.push_front(Entry());
+    _entries.front().path       = path;
+    _entries.front().descriptor = descriptor;
+    _entries.front().size       = (size_t)st.st_size;
+    _index.emplace(path, _entries.begin());
+
+    if (size)
+        *size = (size_t)st.st_size;
+
+    return descriptor;
+}
+
+size_t PlatformAbstractionLayer_POSIX_DescriptorPool::hits() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _hits;
+}
+
+size_t PlatformAbstractionLayer_POSIX_DescriptorPool::misses() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _misses;
+}
+
+size_t PlatformAbstractionLayer_POSIX_DescriptorPool::evictions() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _evictions;
+}
+
+PlatformAbstractionLayer_POSIX_FileMapping::PlatformAbstractionLayer_POSIX_FileMapping(int desc) : _data(nullptr), _length(0) {
+    struct stat st;
+
+    if (desc < 0 || fstat(desc, &st) || st.st_size <= 0)
+        return;
+
+    void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, desc, 0);
+    if (data == MAP_FAILED)
+        return;
+
+    _data   = (const uint8_t*)data;
+    _length = (size_t)st.st_size;
+}
+
+PlatformAbstractionLayer_POSIX_FileMapping::~PlatformAbstractionLayer_POSIX_FileMapping() {
+    if (_data)
+        munmap((void*)_data, _length);
+}
+
+PlatformAbstractionLayer_POSIX::PlatformAbstractionLayer_POSIX(const std::string& folder, size_t maximumOpenFiles) : _folder(folder), _descriptors(maximumOpenFiles) {
     if (_folder.length() == 0) {
         _folder = "./";
         return;
@@ -62,6 +174,10 @@ std::string PlatformAbstractionLayer_POSIX::fullPathName(const char* fileName) c
     return _folder + fileName;
 }
 
+std::shared_ptr<PlatformAbstractionLayer_POSIX_FileDescriptor> PlatformAbstractionLayer_POSIX::descriptor(const char* fileName, size_t* size) const {
+    return _descriptors.acquire(fullPathName(fileName), size);
+}
+
 bool PlatformAbstractionLayer_POSIX::fileExists(const char* fileName) const {
     if (access(fullPathName(fileName).c_str(), R_OK))
         return false;
@@ -70,28 +186,121 @@ bool PlatformAbstractionLayer_POSIX::fileExists(const char* fileName) const {
 }
 
 size_t PlatformAbstractionLayer_POSIX::fileSize(const char* fileName) const {
-    struct stat st;
+    size_t size;
 
-    if (stat(fullPathName(fileName).c_str(), &st))
+    if (!descriptor(fileName, &size))
         return (size_t)-1u;
 
-    return (size_t)st.st_size;
+    return size;
 }
 
-bool PlatformAbstractionLayer_POSIX::fileRead(const char* fileName, size_t offset, void* data, size_t length) const {
-    std::unique_ptr<PlatformAbstractionLayer_POSIX_FileDescriptor> fd(new PlatformAbstractionLayer_POSIX_FileDescriptor(open(fullPathName(fileName).c_str(), O_RDONLY)));
+const PlatformAbstractionLayer_POSIX_FileMapping* PlatformAbstractionLayer_POSIX::mapping(const char* fileName, bool create) const {
+    std::lock_guard<std::mutex> lock(_mappingsLock);
+
+    auto it(_mappings.find(fileName));
+    if (it != _mappings.end())
+        return it->second->valid() ? it->second.get() : nullptr;
+
+    if (!create)
+        return nullptr;
+
+    // Failed mappings are remembered too, so that we don't retry on every view.
+    auto fd(descriptor(fileName, nullptr));
+    std::unique_ptr<PlatformAbstractionLayer_POSIX_FileMapping> map(new PlatformAbstractionLayer_POSIX_FileMapping(fd ? fd->desc() : -1));
+    const PlatformAbstractionLayer_POSIX_FileMapping* result = map->valid() ? map.get() : nullptr;
+
+    _mappings.emplace(fileName, std::move(map));
+    return result;
+}
+
+Span<const uint8_t> PlatformAbstractionLayer_POSIX::fileView(const char* fileName, size_t offset, size_t length) const {
+    const PlatformAbstractionLayer_POSIX_FileMapping* map = mapping(fileName, true);
+    if (!map || offset > map->length() || length > (map->length() - offset))
+        return Span<const uint8_t>();
 
-    if (offset) {
-        if (lseek(fd->desc(), offset, SEEK_SET) == -1)
-            throw std::runtime_error(strerror(errno));
+    return Span<const uint8_t>(map->data() + offset, length);
+}
+
+bool PlatformAbstractionLayer_POSIX::fileRead(const char* fileName, size_t offset, void* data, size_t length) const {
+    if (const PlatformAbstractionLayer_POSIX_FileMapping* map = mapping(fileName, false)) {
+        if (offset <= map->length() && length <= (map->length() - offset)) {
+            memcpy(data, map->data() + offset, length);
+            return true;
+        }
     }
 
-    if (fd->readall(data, length) < 0)
+    auto fd(descriptor(fileName, nullptr));
+    if (!fd)
+        throw std::runtime_error(strerror(errno));
+
+    if (fd->preadall(data, length, offset) < 0)
         throw std::runtime_error(strerror(errno));
 
     return true;
 }
 
+int64_t PlatformAbstractionLayer_POSIX::fileModificationTime(const char* fileName) const {
+    struct stat st;
+
+    // Not the pooled descriptor, which may still refer to a file since replaced.
+    if (stat(fullPathName(fileName).c_str(), &st))
+        return -1;
+
+#if defined(__APPLE__)
+    const struct timespec& time = st.st_mtimespec;
+#else
+    const struct timespec& time = st.st_mtim;
+#endif
+
+    return ((int64_t)time.tv_sec * 1000000000) + (int64_t)time.tv_nsec;
+}
+
+bool PlatformAbstractionLayer_POSIX::fileWrite(const char* fileName, const void* data, size_t length) const {
+    std::string path(fullPathName(fileName));
+    std::vector<char> temporaryPath(path.begin(), path.end());
+
+    // A unique name per writer, in the same folder so that rename() stays atomic.
+    static const char suffix[] = ".XXXXXX";
+    temporaryPath.insert(temporaryPath.end(), suffix, suffix + sizeof(suffix));
+
+    {
+        PlatformAbstractionLayer_POSIX_FileDescriptor fd(mkstemp(temporaryPath.data()));
+        if (fd.desc() < 0)
+            return false;
+
+        bool written = fchmod(fd.desc(), 0644) == 0;
+
+        while (written && length) {
+            ssize_t thisWrite = write(fd.desc(), data, length);
+            if (thisWrite < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                written = false;
+                break;
+            }
+
+            data    = ((const uint8_t*)data) + thisWrite;
+            length -= thisWrite;
+        }
+
+        // The data must be on disk before the new name is, or a crash could leave
+        // an empty file behind.
+        if (!written || fsync(fd.desc())) {
+            unlink(temporaryPath.data());
+            return false;
+        }
+    }
+
+    // Readers either see the previous file or the new one, never a partial write.
+    if (rename(temporaryPath.data(), path.c_str())) {
+        unlink(temporaryPath.data());
+        return false;
+    }
+
+    return true;
+}
+
 std::vector<std::string> PlatformAbstractionLayer_POSIX::fileList() const {
     DIR *dir = opendir(_folder.c_str());
     if (!dir)
@@ -100,7 +309,7 @@ std::vector<std::string> PlatformAbstractionLayer_POSIX::fileList() const {
     std::vector<std::string> files;
 
     while (struct dirent *entry = readdir(dir)) {
-        std::string name(entry->d_name, entry->d_namlen);
+        std::string name(entry->d_name);
         if (name == "." || name == ".." || name[0] == '.')
             continue;
 
@@ -10,6 +10,11 @@
 
 #include "PlatformAbstractionLayer.hpp"
 
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 namespace AGI { namespace Resources {
 
 class PlatformAbstractionLayer_POSIX_FileDescriptor {
@@ -24,6 +29,56 @@ public:
 
 public:
     ssize_t readall(void* data, size_t length);
+    ssize_t preadall(void* data, size_t length, size_t offset) const;
+};
+
+/**
+ * Bounded, least recently used pool of open file descriptors. Descriptors are
+ * shared, reads are expected to go through preadall() so that several threads
+ * can use the same descriptor without seeking. The file size is captured once
+ * when the descriptor is opened.
+ */
+class PlatformAbstractionLayer_POSIX_DescriptorPool {
+private:
+    class Entry {
+    public:
+        std::string                                                    path;
+        std::shared_ptr<PlatformAbstractionLayer_POSIX_FileDescriptor> descriptor;
+        size_t                                                         size;
+    };
+
+    mutable std::mutex                                                 _lock;
+    size_t                                                             _capacity;
+    std::list<Entry>                                                   _entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator>        _index;
+    size_t                                                             _hits;
+    size_t                                                             _misses;
+    size_t                                                             _evictions;
+
+public:
+    PlatformAbstractionLayer_POSIX_DescriptorPool(size_t capacity);
+
+public:
+    std::shared_ptr<PlatformAbstractionLayer_POSIX_FileDescriptor> acquire(const std::string& path, size_t* size);
+
+public:
+    size_t hits() const;
+    size_t misses() const;
+    size_t evictions() const;
+};
+
+class PlatformAbstractionLayer_POSIX_FileMapping {
+public:
+    const uint8_t* _data;
+    size_t         _length;
+
+public:
+    PlatformAbstractionLayer_POSIX_FileMapping(int desc);
+    ~PlatformAbstractionLayer_POSIX_FileMapping();
+
+    inline const uint8_t* data()   const { return _data; }
+    inline size_t         length() const { return _length; }
+    inline bool           valid()  const { return _data != nullptr; }
 };
 
 class PlatformAbstractionLayer_POSIX : public PlatformAbstractionLayer
@@ -31,17 +86,30 @@ class PlatformAbstractionLayer_POSIX : public PlatformAbstractionLayer
 protected:
     std::string _folder;
 
+    mutable PlatformAbstractionLayer_POSIX_DescriptorPool _descriptors;
+
+    mutable std::mutex _mappingsLock;
+    mutable std::unordered_map<std::string, std::unique_ptr<PlatformAbstractionLayer_POSIX_FileMapping>> _mappings;
+
 protected:
     std::string fullPathName(const char* fileName) const;
+    const PlatformAbstractionLayer_POSIX_FileMapping* mapping(const char* fileName, bool create) const;
+    std::shared_ptr<PlatformAbstractionLayer_POSIX_FileDescriptor> descriptor(const char* fileName, size_t* size) const;
+
+public:
+    PlatformAbstractionLayer_POSIX(const std::string& folder, size_t maximumOpenFiles = 16);
 
 public:
-    PlatformAbstractionLayer_POSIX(const std::string& folder);
+    inline const PlatformAbstractionLayer_POSIX_DescriptorPool& descriptorPool() const { return _descriptors; }
 
 public:
     virtual bool fileExists(const char* fileName) const override;
     virtual size_t fileSize(const char* fileName) const override;
     virtual bool fileRead(const char* fileName, size_t offset, void* data, size_t length) const override;
     virtual std::vector<std::string> fileList() const override;
+    virtual Span<const uint8_t> fileView(const char* fileName, size_t offset, size_t length) const override;
+    virtual int64_t fileModificationTime(const char* fileName) const override;
+    virtual bool fileWrite(const char* fileName, const void* data, size_t length) const override;
 };
 
 }}
@@ -24,16 +24,16 @@ PlatformAbstractionLayer_macOS::PlatformAbstractionLayer_macOS(const std::string
 }
 
 std::string PlatformAbstractionLayer_macOS::fileMD5Hash(const char* fileName) const {
-    struct stat st;
-    std::unique_ptr<PlatformAbstractionLayer_POSIX_FileDescriptor> fd(new PlatformAbstractionLayer_POSIX_FileDescriptor(open(fullPathName(fileName).c_str(), O_RDONLY)));
-    if (fstat(fd->desc(), &st))
+    size_t size;
+    auto fd(descriptor(fileName, &size));
+    if (!fd)
         throw std::runtime_error(strerror(errno));
 
     uint8_t hash[CC_MD5_DIGEST_LENGTH];
     std::vector<uint8_t> data;
 
-    data.resize(st.st_size);
-    if (fd->readall(data.data(), data.size()) < 0)
+    data.resize(size);
+    if (fd->preadall(data.data(), data.size(), 0) < 0)
         throw std::runtime_error(strerror(errno));
 
     if (!CC_MD5(data.data(), (CC_LONG)data.size(), hash))
@@ -0,0 +1,59 @@
+//
+//  Span.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIResources__Span_hpp__
+#define __AGIResources__Span_hpp__
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace AGI { namespace Resources {
+
+    /**
+     * Non-owning view over a contiguous range of memory, typically a part of a
+     * memory mapped file. The memory must outlive the span.
+     */
+    template <typename T>
+    class Span {
+    private:
+        T*     _data;
+        size_t _size;
+
+    public:
+        inline Span() : _data(nullptr), _size(0) {
+        }
+
+        inline Span(T* data, size_t size) : _data(data), _size(size) {
+        }
+
+        template <typename U>
+        inline Span(const Span<U>& other) : _data(other.data()), _size(other.size()) {
+        }
+
+    public:
+        inline T*     data()  const { return _data; }
+        inline size_t size()  const { return _size; }
+        inline bool   empty() const { return _size == 0; }
+        inline T*     begin() const { return _data; }
+        inline T*     end()   const { return _data + _size; }
+
+        inline T& operator [] (size_t index) const {
+            assert(index < _size);
+            return _data[index];
+        }
+
+        inline Span subspan(size_t offset, size_t count) const {
+            assert(offset <= _size);
+            assert(count <= (_size - offset));
+            return Span(_data + offset, count);
+        }
+    };
+
+}}
+
+#endif /* __AGIResources__Span_hpp__ */
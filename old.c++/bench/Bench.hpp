@@ -0,0 +1,54 @@
+//
+//  Bench.hpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+
+#ifndef __AGIBench__Bench_hpp__
+#define __AGIBench__Bench_hpp__
+
+#include <chrono>
+
+#if defined(__APPLE__)
+#include "AGIResources/PlatformAbstractionLayer_macOS.hpp"
+typedef AGI::Resources::PlatformAbstractionLayer_macOS PlatformAbstractionLayer_Native;
+#else
+#include "AGIResources/PlatformAbstractionLayer_Linux.hpp"
+typedef AGI::Resources::PlatformAbstractionLayer_Linux PlatformAbstractionLayer_Native;
+#endif
+
+namespace AGI { namespace Bench {
+
+    /**
+     * Runs the function the given number of times and returns the fastest run, in
+     * seconds. The best run is the one least disturbed by the rest of the system.
+     */
+    template<typename Function>
+    double bestOf(int runs, const Function& function) {
+        double best = 0;
+
+        for (int run = 0; run < runs; run++) {
+            auto   start   = std::chrono::steady_clock::now();
+            function();
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (run == 0 || elapsed < best)
+                best = elapsed;
+        }
+
+        return best;
+    }
+
+    /**
+     * Keeps the compiler from optimizing away a result the benchmark doesn't
+     * otherwise use.
+     */
+    template<typename T>
+    inline void keep(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+}}
+
+#endif /* __AGIBench__Bench_hpp__ */
@@ -0,0 +1,66 @@
+//
+//  crypt_kernels.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+//  Throughput of every XOR decryption kernel this processor can run, on buffers
+//  of the sizes logic messages and whole volumes come in.
+//
+//  usage: crypt_kernels
+//
+
+#include "Bench.hpp"
+
+#include "AGIResources/Crypt.hpp"
+
+#include <iostream>
+#include <vector>
+
+using namespace AGI::Bench;
+using namespace AGI::Resources;
+
+int main() {
+    static const char*  kernels[] = { "scalar", "words", "sse2", "avx2" };
+    static const size_t sizes[]   = { 64, 1024, 64 * 1024, 1024 * 1024 };
+    static const size_t total     = 256 * 1024 * 1024;
+
+    const CryptKey& key = CryptKey::sierra();
+
+    std::cout << "selected kernel: " << CryptKey::kernel() << std::endl;
+
+    for (size_t size : sizes) {
+        std::vector<uint8_t> reference(size);
+        std::vector<uint8_t> data(size);
+
+        for (size_t i = 0; i < size; i++)
+            reference[i] = (uint8_t)(i * 131 + 7);
+
+        std::vector<uint8_t> expected(reference);
+        key.apply(expected.data(), expected.size(), "scalar");
+
+        for (const char* kernel : kernels) {
+            data = reference;
+
+            if (!key.apply(data.data(), data.size(), kernel))
+                continue;
+
+            if (data != expected) {
+                std::cerr << kernel << " does not match the scalar kernel on " << size << " bytes" << std::endl;
+                return 1;
+            }
+
+            size_t rounds  = total / size;
+            double seconds = bestOf(5, [&]() {
+                for (size_t round = 0; round < rounds; round++)
+                    key.apply(data.data(), data.size(), kernel);
+
+                keep(data[0]);
+            });
+
+            std::cout << kernel << "\t" << size << " bytes\t" << (rounds * size) / seconds / (1024 * 1024) << " MB/s" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+//
+//  lzw_decode.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+//  Decoding throughput of LZWDecoder against LZWExpander. The corpus is every
+//  resource of the given games, recompressed with LZWCompressor, or synthetic
+//  picture-like data when no game is given. Both decoders must give back the
+//  original bytes.
+//
+//  usage: lzw_decode [game folder...]
+//
+
+#include "Bench.hpp"
+
+#include "AGIResources/GameVolume.hpp"
+#include "AGIResources/LZWCompress.hpp"
+#include "AGIResources/LZWExpand.hpp"
+
+#include <iostream>
+
+using namespace AGI::Bench;
+using namespace AGI::Resources;
+
+namespace {
+
+    class Sample {
+    public:
+        std::vector<uint8_t> original;
+        std::vector<uint8_t> compressed;
+    };
+
+    void addSample(std::vector<Sample>& corpus, std::vector<uint8_t>&& original) {
+        if (original.empty())
+            return;
+
+        Sample sample;
+        sample.compressed = LZWCompress(original.data(), original.size());
+        sample.original   = std::move(original);
+        corpus.push_back(std::move(sample));
+    }
+
+    void addGame(std::vector<Sample>& corpus, const char* folder) {
+        GameVolume game(new PlatformAbstractionLayer_Native(folder));
+
+        game.enumerate([&corpus](GameVolume& volume, GameFile file, uint8_t id, size_t) {
+            addSample(corpus, volume.load(file, id));
+        });
+    }
+
+    /**
+     * Runs of a few colors with the odd command byte in between, roughly what a
+     * picture resource looks like.
+     */
+    void addSynthetic(std::vector<Sample>& corpus) {
+        uint32_t seed = 12345;
+
+        for (size_t count = 0; count < 256; count++) {
+            std::vector<uint8_t> data(1024 + (count * 97) % 15000);
+
+            for (size_t i = 0; i < data.size(); i++) {
+                seed = seed * 1103515245 + 12345;
+
+                if ((seed >> 24) < 240 && i > 0)
+                    data[i] = data[i - 1 - (seed >> 8) % std::min<size_t>(i, 4)];
+                else
+                    data[i] = (uint8_t)(0xf0 | ((seed >> 16) & 0x0f));
+            }
+
+            addSample(corpus, std::move(data));
+        }
+    }
+
+    template<typename Decoder>
+    bool verify(Decoder& decoder, const std::vector<Sample>& corpus) {
+        std::vector<uint8_t> output;
+
+        for (const Sample& sample : corpus) {
+            output.assign(sample.original.size(), 0);
+
+            if (!decoder.expand(Span<const uint8_t>(sample.compressed.data(), sample.compressed.size()), Span<uint8_t>(output.data(), output.size())))
+                return false;
+
+            if (output != sample.original)
+                return false;
+        }
+
+        return true;
+    }
+
+    template<typename Decoder>
+    double measure(Decoder& decoder, const std::vector<Sample>& corpus, size_t rounds) {
+        std::vector<uint8_t> output(64 * 1024);
+
+        return bestOf(5, [&]() {
+            for (size_t round = 0; round < rounds; round++) {
+                for (const Sample& sample : corpus) {
+                    if (output.size() < sample.original.size())
+                        output.resize(sample.original.size());
+
+                    decoder.expand(Span<const uint8_t>(sample.compressed.data(), sample.compressed.size()), Span<uint8_t>(output.data(), sample.original.size()));
+                }
+
+                keep(output[0]);
+            }
+        });
+    }
+
+}
+
+int main(int argc, const char * argv[]) {
+    std::vector<Sample> corpus;
+
+    try {
+        for (int index = 1; index < argc; index++)
+            addGame(corpus, argv[index]);
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    if (argc < 2)
+        addSynthetic(corpus);
+
+    size_t decoded = 0, encoded = 0;
+
+    for (const Sample& sample : corpus) {
+        decoded += sample.original.size();
+        encoded += sample.compressed.size();
+    }
+
+    std::cout << corpus.size() << " resources, " << encoded << " bytes compressed, " << decoded << " bytes decoded" << std::endl;
+
+    std::unique_ptr<LZWExpander> expander(new LZWExpander());
+    std::unique_ptr<LZWDecoder>  decoder(new LZWDecoder());
+
+    if (!verify(*expander, corpus) || !verify(*decoder, corpus)) {
+        std::cerr << "A decoder did not give back the original data" << std::endl;
+        return 1;
+    }
+
+    size_t rounds         = std::max<size_t>(1, (64 * 1024 * 1024) / std::max<size_t>(decoded, 1));
+    double expanderTime   = measure(*expander, corpus, rounds);
+    double decoderTime    = measure(*decoder,  corpus, rounds);
+    double megabytes      = (double)(decoded * rounds) / (1024 * 1024);
+
+    std::cout << "LZWExpander\t" << megabytes / expanderTime << " MB/s" << std::endl;
+    std::cout << "LZWDecoder\t"  << megabytes / decoderTime  << " MB/s" << std::endl;
+    std::cout << "speedup\t\t"   << expanderTime / decoderTime << "x" << std::endl;
+    return 0;
+}
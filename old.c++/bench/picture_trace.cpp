@@ -0,0 +1,161 @@
+//
+//  picture_trace.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+//  Renders every picture of the given games through PictureRasterizer, decoded
+//  with decode() and traced through virtual calls, and through
+//  StaticPictureRasterizer, decoded with decodeInline(). Both must draw the same
+//  planes. Throughput is reported for full renders and, since fills make up most
+//  of a render, for renders with fills left out, which time line and pattern
+//  plotting alone.
+//
+//  usage: picture_trace <game folder...>
+//
+
+#include "Bench.hpp"
+
+#include "AGIResources/GameVolume.hpp"
+#include "AGIResources/PictureRasterizer.hpp"
+
+#include <iostream>
+#include <string.h>
+
+using namespace AGI::Bench;
+using namespace AGI::Resources;
+
+namespace {
+
+    class Picture {
+    public:
+        const GameInfo*      info;
+        std::vector<uint8_t> data;
+    };
+
+    class Planes {
+    public:
+        uint8_t screen[PictureWidth * PictureHeight];
+        uint8_t priority[PictureWidth * PictureHeight];
+
+        inline void clear() {
+            memset(screen, 15, sizeof(screen));
+            memset(priority, 4, sizeof(priority));
+        }
+
+        inline bool operator == (const Planes& other) const {
+            return memcmp(screen, other.screen, sizeof(screen)) == 0 && memcmp(priority, other.priority, sizeof(priority)) == 0;
+        }
+    };
+
+    class LinePictureRasterizer : public PictureRasterizer {
+    public:
+        inline LinePictureRasterizer(const GameInfo& info, uint8_t* screen, uint8_t* priority, bool clear) : PictureRasterizer(info, screen, priority, clear) {
+        }
+
+        virtual void drawFill(uint8_t, uint8_t) override {
+        }
+    };
+
+    class LineStaticPictureRasterizer : public StaticPictureRasterizer {
+    public:
+        inline LineStaticPictureRasterizer(const GameInfo& info, uint8_t* screen, uint8_t* priority) : StaticPictureRasterizer(info, screen, priority) {
+        }
+
+        inline void drawFill(uint8_t, uint8_t) {
+        }
+    };
+
+    template<typename Rasterizer>
+    void renderVirtual(const Picture& picture, Planes& planes) {
+        PictureDecoder decoder(Span<const uint8_t>(picture.data.data(), picture.data.size()));
+        Rasterizer     rasterizer(*picture.info, planes.screen, planes.priority, false);
+
+        planes.clear();
+        decoder.decode(rasterizer);
+    }
+
+    template<typename Rasterizer>
+    void renderStatic(const Picture& picture, Planes& planes) {
+        PictureDecoder decoder(Span<const uint8_t>(picture.data.data(), picture.data.size()));
+        Rasterizer     rasterizer(*picture.info, planes.screen, planes.priority);
+
+        planes.clear();
+        decoder.decodeInline(rasterizer);
+    }
+
+    template<typename Render>
+    void measure(const char* name, const std::vector<Picture>& pictures, const Render& render) {
+        static const size_t rounds = 20;
+
+        std::unique_ptr<Planes> planes(new Planes());
+
+        double seconds = bestOf(7, [&]() {
+            for (size_t round = 0; round < rounds; round++) {
+                for (const Picture& picture : pictures)
+                    render(picture, *planes);
+            }
+
+            keep(planes->screen[0]);
+        });
+
+        double count = (double)(pictures.size() * rounds);
+
+        std::cout << name << "\t" << count / seconds << " pictures/s\t"
+                  << count * PictureWidth * PictureHeight / seconds / 1e6 << " Mpixels/s" << std::endl;
+    }
+
+}
+
+int main(int argc, const char * argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <game folder...>" << std::endl;
+        return 2;
+    }
+
+    std::vector<std::unique_ptr<GameVolume>> games;
+    std::vector<Picture>                     pictures;
+
+    try {
+        for (int index = 1; index < argc; index++) {
+            games.emplace_back(new GameVolume(new PlatformAbstractionLayer_Native(argv[index])));
+
+            GameVolume& game = *games.back();
+
+            game.enumerate([&pictures](GameVolume& volume, GameFile file, uint8_t id, size_t) {
+                if (file != GameFile::Picture)
+                    return;
+
+                Picture picture;
+                picture.info = &volume.info();
+                picture.data = volume.load(file, id);
+                pictures.push_back(std::move(picture));
+            });
+        }
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<Planes> expected(new Planes());
+    std::unique_ptr<Planes> actual(new Planes());
+
+    for (const Picture& picture : pictures) {
+        renderVirtual<PictureRasterizer>(picture, *expected);
+        renderStatic<StaticPictureRasterizer>(picture, *actual);
+
+        if (!(*expected == *actual)) {
+            std::cerr << "StaticPictureRasterizer does not draw what PictureRasterizer draws" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << pictures.size() << " pictures" << std::endl;
+
+    measure("virtual",            pictures, renderVirtual<PictureRasterizer>);
+    measure("static",             pictures, renderStatic<StaticPictureRasterizer>);
+    measure("virtual, no fills",  pictures, renderVirtual<LinePictureRasterizer>);
+    measure("static, no fills",   pictures, renderStatic<LineStaticPictureRasterizer>);
+    return 0;
+}
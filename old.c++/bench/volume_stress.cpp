@@ -0,0 +1,126 @@
+//
+//  volume_stress.cpp
+//  AGI
+//
+//  Copyright (c) 2018 Princess Rosella. All rights reserved.
+//
+//  Many threads loading from one GameVolume at once, through load(),
+//  loadShared() and pin(), with a cache budget small enough to keep evicting.
+//  Every resource they get must match what a single thread loads from a volume
+//  of its own. Exits with 1 on the first mismatch.
+//
+//  usage: volume_stress <game folder> [threads] [rounds]
+//
+
+#include "Bench.hpp"
+
+#include "AGIResources/GameVolume.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <thread>
+
+using namespace AGI::Resources;
+
+namespace {
+
+    typedef std::pair<GameFile, uint8_t> ResourceKey;
+
+    std::map<ResourceKey, std::vector<uint8_t>> loadReference(const char* folder) {
+        std::map<ResourceKey, std::vector<uint8_t>> reference;
+        GameVolume                                  game(new PlatformAbstractionLayer_Native(folder));
+
+        game.enumerate([&reference](GameVolume& volume, GameFile file, uint8_t id, size_t) {
+            reference[ResourceKey(file, id)] = volume.load(file, id);
+        });
+
+        return reference;
+    }
+
+}
+
+int main(int argc, const char * argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <game folder> [threads] [rounds]" << std::endl;
+        return 2;
+    }
+
+    size_t threadCount = argc > 2 ? (size_t)atoi(argv[2]) : std::max<size_t>(4, std::thread::hardware_concurrency());
+    size_t rounds      = argc > 3 ? (size_t)atoi(argv[3]) : 20;
+
+    try {
+        auto                     reference = loadReference(argv[1]);
+        std::vector<ResourceKey> keys;
+        size_t                   totalSize = 0;
+
+        for (const auto& resource : reference) {
+            keys.push_back(resource.first);
+            totalSize += resource.second.size();
+        }
+
+        // The threads start on a volume nobody has touched yet, so that they race
+        // on opening the volumes and parsing the directories too.
+        GameVolume          game(new PlatformAbstractionLayer_Native(argv[1]));
+        std::atomic<bool>   start(false);
+        std::atomic<size_t> mismatches(0);
+        std::atomic<size_t> loads(0);
+        std::vector<std::thread> threads;
+
+        game.setCacheBudget(totalSize / 4);
+
+        for (size_t index = 0; index < threadCount; index++) {
+            threads.emplace_back([&, index]() {
+                uint32_t seed = (uint32_t)index * 2654435761u + 1;
+
+                while (!start)
+                    std::this_thread::yield();
+
+                for (size_t round = 0; round < rounds; round++) {
+                    for (size_t count = 0; count < keys.size(); count++) {
+                        seed = seed * 1103515245 + 12345;
+
+                        const ResourceKey&          key      = keys[(seed >> 8) % keys.size()];
+                        const std::vector<uint8_t>& expected = reference.at(key);
+                        bool                        matches;
+
+                        if ((seed & 0xc0) == 0xc0) {
+                            GameResource resource(game.pin(key.first, key.second));
+                            matches = resource && *resource == expected;
+                            game.unpin(key.first, key.second);
+                        }
+                        else if (seed & 0x80) {
+                            GameResource resource(game.loadShared(key.first, key.second));
+                            matches = resource && *resource == expected;
+                        }
+                        else
+                            matches = game.load(key.first, key.second) == expected;
+
+                        if (!matches && mismatches++ == 0)
+                            std::cerr << "Mismatch on file " << (int)key.first << " resource " << (int)key.second << std::endl;
+
+                        loads++;
+                    }
+                }
+            });
+        }
+
+        auto started = std::chrono::steady_clock::now();
+
+        start = true;
+
+        for (auto& thread : threads)
+            thread.join();
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        std::cout << threadCount << " threads, " << loads << " loads of " << keys.size() << " resources in " << seconds << " s, "
+                  << loads / seconds << " loads/s, " << mismatches << " mismatches" << std::endl;
+
+        return mismatches == 0 ? 0 : 1;
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+}
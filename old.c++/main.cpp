@@ -15,36 +15,41 @@
 #include "AGIResources/LogicDumper.hpp"
 #include "AGIResources/LogicInstructionSet.hpp"
 #include "AGIResources/PictureRasterizer.hpp"
+
+#if defined(__APPLE__)
 #include "AGIResources/PlatformAbstractionLayer_macOS.hpp"
+typedef AGI::Resources::PlatformAbstractionLayer_macOS PlatformAbstractionLayer_Native;
+#else
+#include "AGIResources/PlatformAbstractionLayer_Linux.hpp"
+typedef AGI::Resources::PlatformAbstractionLayer_Linux PlatformAbstractionLayer_Native;
+#endif
 
 using namespace AGI::Resources;
 
 int main(int argc, const char * argv[]) {
     try {
-        GameVolume game(new PlatformAbstractionLayer_macOS(argv[1]));
+        GameVolume game(new PlatformAbstractionLayer_Native(argv[1]));
 
         std::cout << "Detected: " << game.info().code() << " " << game.info().description() << std::endl;
 
-        game.enumerate([](GameVolume& volume, GameFile file, uint8_t id, size_t length) {
+        game.scan([&game](GameFile file, uint8_t, std::vector<uint8_t>& data) {
             if (file == GameFile::Picture) {
                 uint8_t screen[160 * 168];
                 uint8_t priority[160 * 168];
-                PictureRasterizer rasterizer(volume.info(), screen, priority);
-                PictureDecoder encoded(volume.load(file, id));
+                PictureRasterizer rasterizer(game.info(), screen, priority);
+                PictureDecoder encoded(std::move(data));
 
                 encoded.decode(rasterizer);
                 return;
             }
             else if (file == GameFile::Logic) {
-                LogicDecoder decoder(volume.load(file, id));
+                LogicDecoder decoder(std::move(data));
                 LogicInstructionSet instructionSet;
                 LogicDumper dumper(std::cout);
 
                 decoder.decode(instructionSet, dumper);
                 return;
             }
-
-            volume.load(file, id);
         });
     }
     catch (const std::exception& ex) {